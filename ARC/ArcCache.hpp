@@ -3,11 +3,19 @@
 #ifndef __ARC_CACHE_HPP__
 #define __ARC_CACHE_HPP__
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
 #include "ArcLruPart.hpp"
 #include "ArcLfuPart.hpp"
 #include "../Common/CachePolicy.hpp"
+#include "../Common/ReadBuffer.hpp"
+#include "../Common/SharedValue.hpp"
 
 namespace myCache
 {
@@ -15,11 +23,26 @@ namespace myCache
      * @brief ArcCache 类模板
      * 继承自 CachePolicy 基类，是 ARC 算法的顶层实现。
      * 它组合了 LRU 分量和 LFU 分量，并根据“幽灵命中”动态调整两者的配额。
+     * 容量按 Weigher 计算的权重累计；幽灵命中时按该条目被淘汰时的权重挪动配额。
+     * 线程安全：一次读写要依次查看幽灵列表、T1、T2 并可能在两部分之间挪动配额，
+     * 因此由一把锁同时保护四个列表（T1 / B1 / T2 / B2），两个分量自身不再加锁。
      */
-    template<class Key, class Value>
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
     class ArcCache : public CachePolicy<Key,Value>
     {
+        template<class K, class V, template<class, class, class> class P, class W>
+        friend class ConcurrentCache; // ConcurrentCache 在自己的写锁内直接调用不加锁的 visitLocked / putLocked / removeLocked
+
     private:
+        /**
+         * @brief 每次操作只算一次的混淆哈希：T1 / T2 两个索引与 B1 / B2 两个幽灵列表的指纹都使用这个值
+         */
+        template<class K>
+        static uint64_t hashOf(const K& key)
+        {
+            return cacheHashOf<Key>(key);
+        }
+
         /**
          * @brief 检查幽灵缓存并执行自适应调整
          * 这是 ARC 的灵魂所在：
@@ -27,43 +50,105 @@ namespace myCache
          * 2. 如果命中 LFU 的幽灵缓存：说明高频数据被错误踢出了，应该增加 LFU 部分的容量。
          * @return bool 是否命中任何幽灵缓存
          */
-        bool checkGhostCaches(Key key)
+        bool checkGhostCaches(uint64_t hash)
         {
             bool inGhost = false;
+            size_t weight = 0;
             // 情况 A：在 LRU 的幽灵列表中找到（说明该 Key 刚被 LRU 踢出不久又被访问了）
-            if(_lruPart->checkGhost(key))
+            if(_lruPart->checkGhost(hash, weight))
             {
                 // 策略：缩小 LFU 空间，挪给 LRU
-                if(_lfuPart->decreaseCapacity())
-                {
-                    _lruPart->increaseCapacity();
-                }
+                _lruPart->increaseCapacity(_lfuPart->decreaseCapacity(weight));
                 inGhost = true;
             }
             // 情况 B：在 LFU 的幽灵列表中找到（说明该 Key 曾是高频数据，踢出它是个错误）
-            else if(_lfuPart->checkGhost(key))
+            else if(_lfuPart->checkGhost(hash, weight))
             {
                 // 策略：缩小 LRU 空间，挪给 LFU
-                if(_lruPart->decreaseCapacity())
-                {
-                    _lfuPart->increaseCapacity();
-                }
+                _lfuPart->increaseCapacity(_lruPart->decreaseCapacity(weight));
                 inGhost = true;
             }
             return inGhost;
         }   
 
+        /**
+         * @brief 将 LRU 部分命中的数据晋升到 LFU 部分
+         * 以异构类型查找命中时，只有真正需要晋升的这一次才构造 Key
+         */
+        template<class V>
+        void promote(const Key& key, uint64_t hash, V&& value)
+        {
+            size_t weight = _weigher(key, value);
+            _lfuPart->put(key, hash, std::forward<V>(value), weight);
+        }
+
+        template<class K, class V, EnableIfLookupKey<Key, K> = 0>
+        void promote(const K& key, uint64_t hash, V&& value)
+        {
+            promote(Key(key), hash, std::forward<V>(value));
+        }
+
+        /**
+         * @brief 读缓冲模式下的快速路径：在共享锁下处理不需要修改结构的读取
+         * Key 不在 T1、也不在 B1 / B2 时，完整路径中的幽灵调整与 T1 查找都不产生任何效果，
+         * 结果只取决于 T2：命中时查找 T2 并记录访问，不在 T2 中则可以直接判定未命中。
+         * 四次探测共用调用方算好的同一个哈希；T1 放在最前面，它是需要晋升的读取最先出局的地方。
+         * 注意共享锁本身仍是对锁字的原子读-改-写，这里省掉的是链表调整和独占锁的等待，读者依旧在锁字所在的缓存行上排队。
+         * @param hit 结果已确定时传出是否命中
+         * @return 结果是否已在快速路径中确定；返回 false 时由调用方走独占锁的完整路径
+         */
+        template<class K, class Fn>
+        bool tryReadShared(const K& key, uint64_t hash, Fn&& fn, bool& hit)
+        {
+            bool shouldDrain = false;
+            {
+                std::shared_lock<CacheMutex> lock(_mutex);
+                if(_lruPart->contain(key, hash) || _lruPart->hasGhost(hash) || _lfuPart->hasGhost(hash)) return false;
+                hit = _lfuPart->visitBuffered(key, hash, fn, shouldDrain);
+            }
+            if(shouldDrain)
+            {
+                std::unique_lock<CacheMutex> lock(_mutex, std::try_to_lock);
+                if(lock.owns_lock()) _lfuPart->drainReadBuffer();
+            }
+            return true;
+        }
+
+        /**
+         * @brief 读取逻辑：get / visit 及其带哈希版本共用，Key 与异构查找类型共用
+         * 哈希在加锁前算好，临界区内只做探测
+         */
+        template<class K, class Fn>
+        bool readImpl(const K& key, uint64_t hash, Fn&& fn)
+        {
+            bool hit = false;
+            if(_lfuPart->bufferedReads() && tryReadShared(key, hash, fn, hit))
+            {
+                return hit;
+            }
+
+            std::unique_lock<CacheMutex> lock(_mutex);
+            return visitLocked(key, hash, std::forward<Fn>(fn));
+        }
+
     public:
         /**
          * @brief 构造函数
          * @param capacity 缓存总容量
          * @param transformThreshold 晋升门槛（访问多少次后从 LRU 转入 LFU）
+         * @param weigher 权重函数，默认每个条目计 1
+         * @param bufferedReads 是否为 LFU 部分（T2）开启读缓冲：只命中 T2 的读取只取共享锁并记录访问，升频攒批进行；
+         *                      四个列表都不含该 Key 的读取也在共享锁下直接返回未命中。
+         *                      LRU 部分（T1）的命中要当场决定是否晋升，仍然在独占锁下立即处理
          */
-        explicit ArcCache(size_t capacity = 10, size_t transformThreshold = 2)
+        explicit ArcCache(size_t capacity = 10, size_t transformThreshold = 2, Weigher weigher = Weigher(),
+                          bool bufferedReads = false)
             :_capacity(capacity),
              _transformThreshold(transformThreshold),
-             _lruPart(std::make_unique<ArcLruPart<Key, Value>>(capacity, transformThreshold)),
-             _lfuPart(std::make_unique<ArcLfuPart<Key, Value>>(capacity, transformThreshold))
+             _weigher(weigher),
+             _mutex(bufferedReads),
+             _lruPart(std::make_unique<ArcLruPart<Key, Value, Weigher>>(capacity, transformThreshold)),
+             _lfuPart(std::make_unique<ArcLfuPart<Key, Value, Weigher>>(capacity, transformThreshold, weigher, bufferedReads))
         {}
 
         ~ArcCache() override = default;
@@ -72,66 +157,289 @@ namespace myCache
          * @brief 写入数据
          * 首先检查是否存在幽灵命中以调整容量权重，然后优先放入 LRU 部分。
          */
-        void put(Key key, Value value) override
+        void put(const Key& key, const Value& value) override
         {
-            // 1. 尝试根据历史痕迹调整 LRU/LFU 的配额比例
-            checkGhostCaches(key);
+            putImpl(key, hashOf(key), value);
+        }
+
+        /**
+         * @brief 写入数据（右值版本）
+         */
+        void put(const Key& key, Value&& value) override
+        {
+            putImpl(key, hashOf(key), std::move(value));
+        }
+
+        /**
+         * @brief 获取数据
+         * 遵循：LRU 查找 -> 晋升判断 -> LFU 查找 的顺序。
+         */
+        bool get(const Key& key, Value& value) override
+        {
+            return readImpl(key, hashOf(key), [&value](const Value& stored) { value = stored; });
+        }
 
-            // 2. 默认存入 LRU 部分（作为新晋数据）
-            _lruPart->put(key, value);
+        /**
+         * @brief 获取数据（直接返回值版本）
+         */
+        Value get(const Key& key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            return readImpl(key, hashOf(key), [&value](const Value& stored) { value = stored; });
+        }
+
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：命中时在锁内以 const 引用调用 fn(value)
+         * 查找顺序和副作用与 get 相同；只有需要晋升到 LFU 部分时才会拷贝一份值。
+         * fn 中不能再访问本缓存，否则会死锁。
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            return readImpl(key, hashOf(key), std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 带预先算好哈希的读写接口，供分片路由复用同一个哈希值
+         * hash 必须等于 cacheHashOf<Key>(key)，否则查找结果未定义
+         */
+        template<class K>
+        bool getWithHash(const K& key, uint64_t hash, Value& value)
+        {
+            return readImpl(key, hash, [&value](const Value& stored) { value = stored; });
+        }
 
-            // 3. 如果该数据已经在 LFU 部分存在，同步更新 LFU 中的值
-            bool inLfu = _lfuPart->contain(key);
-            if(inLfu)
+        template<class K, class Fn>
+        bool visitWithHash(const K& key, uint64_t hash, Fn&& fn)
+        {
+            return readImpl(key, hash, std::forward<Fn>(fn));
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, const Value& value)
+        {
+            putImpl(key, hash, value);
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, Value&& value)
+        {
+            putImpl(key, hash, std::move(value));
+        }
+
+        /**
+         * @brief 批量读取：整批只加一次独占锁，逐个走与 get 相同的完整路径（幽灵调整、晋升都照常进行）
+         * 开启读缓冲时也不走共享锁的快速路径，一批之中只加锁一次已足以摊薄加锁开销
+         * @param values 输出数组，长度不小于 count；命中的位置写入值，未命中的位置保持不变
+         * @param found 输出数组（可为空），记录每个位置是否命中
+         * @return 命中个数
+         */
+        size_t multiGet(const Key* keys, size_t count, Value* values, bool* found = nullptr)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = hashOf(keys[i]);
+            if(found) std::fill(found, found + count, false);
+            return visitBatchWithHash(keys, hashes.data(), nullptr, count, [values, found](size_t i, const Value& stored)
             {
-                _lfuPart->put(key, value);
+                values[i] = stored;
+                if(found) found[i] = true;
+            });
+        }
+
+        /**
+         * @brief 批量写入：哈希与权重在锁外算好，整批只加一次锁，逐个走与 put 相同的路径
+         */
+        void multiPut(const std::pair<Key, Value>* entries, size_t count)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = hashOf(entries[i].first);
+            putBatchWithHash(entries, hashes.data(), nullptr, count);
+        }
+
+        /**
+         * @brief 批量读取的底层版本，供分片路由按分片分组后调用
+         * 依次处理 indices[0..count) 指向的 Key（indices 为空时处理 0..count-1），hashes 按原下标给出；
+         * 命中时以原下标调用 fn(index, const Value&)，对缓存的影响与逐个 get 相同
+         * @return 命中个数
+         */
+        template<class Fn>
+        size_t visitBatchWithHash(const Key* keys, const uint64_t* hashes, const uint32_t* indices, size_t count, Fn&& fn)
+        {
+            std::unique_lock<CacheMutex> lock(_mutex);
+            size_t hits = 0;
+            for(size_t n = 0; n < count; ++n)
+            {
+                size_t i = indices ? indices[n] : n;
+                if(visitLocked(keys[i], hashes[i], [&fn, i](const Value& stored) { fn(i, stored); })) ++hits;
             }
+            return hits;
         }
 
         /**
-         * @brief 获取数据
-         * 遵循：LRU 查找 -> 晋升判断 -> LFU 查找 的顺序。
+         * @brief 批量写入的底层版本，下标约定与 visitBatchWithHash 相同
          */
-        bool get(Key key, Value& value) override
+        void putBatchWithHash(const std::pair<Key, Value>* entries, const uint64_t* hashes, const uint32_t* indices, size_t count)
+        {
+            auto at = [indices](size_t n) -> size_t { return indices ? indices[n] : n; };
+            std::vector<size_t> weights(count);
+            for(size_t n = 0; n < count; ++n) weights[n] = _weigher(entries[at(n)].first, entries[at(n)].second);
+
+            std::unique_lock<CacheMutex> lock(_mutex);
+            for(size_t n = 0; n < count; ++n)
+            {
+                size_t i = at(n);
+                putLocked(entries[i].first, entries[i].second, weights[n], hashes[i]);
+            }
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（任一分量），不触发幽灵调整也不影响访问状态
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            return containsWithHash(key, hashOf(key));
+        }
+
+        template<class K>
+        bool containsWithHash(const K& key, uint64_t hash)
+        {
+            std::shared_lock<CacheMutex> lock(_mutex);
+            return _lruPart->contain(key, hash) || _lfuPart->contain(key, hash);
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项（两个分量中的副本都会删除，不留下幽灵痕迹）
+         */
+        template<class K>
+        void remove(const K& key)
+        {
+            removeWithHash(key, hashOf(key));
+        }
+
+        template<class K>
+        void removeWithHash(const K& key, uint64_t hash)
+        {
+            std::unique_lock<CacheMutex> lock(_mutex);
+            removeLocked(key, hash);
+        }
+
+    protected:
+        /**
+         * 以下接口不加锁，调用方持有 _mutex 的独占锁（ConcurrentCache 则用自己的写锁串行化）；
+         * hash 必须等于 cacheHashOf<Key>(key)
+         */
+
+        /**
+         * @brief 完整的读取路径：幽灵调整 -> LRU 查找与晋升 -> LFU 查找，命中时以 const 引用调用 fn(value)
+         */
+        template<class K, class Fn>
+        bool visitLocked(const K& key, uint64_t hash, Fn&& fn)
         {
             // 每次访问前先通过幽灵列表学习用户偏好
-            checkGhostCaches(key);
-            
+            checkGhostCaches(hash);
+
             bool shouldTransform = false;
-            // 1. 先在 LRU（新近数据区）查找
-            if(_lruPart->get(key, value, shouldTransform))
+            Value promoted{};
+            // 1. 先在 LRU（新近数据区）查找；shouldTransform 在调用回调之前就已算出，只在需要晋升时留下拷贝
+            bool inLru = _lruPart->visit(key, hash, [&](const Value& value)
+            {
+                if(shouldTransform) promoted = value;
+                fn(value);
+            }, shouldTransform);
+            if(inLru)
             {
-                // 如果命中且达到了晋升阈值（如访问了 2 次）
+                // 如果命中且达到了晋升阈值（如访问了 2 次），将其从 LRU 移动（晋升）到 LFU 长期关注区
                 if(shouldTransform)
                 {
-                    // 将其从 LRU 移动（晋升）到 LFU 长期关注区
-                    _lfuPart->put(key, value);
+                    promote(key, hash, std::move(promoted));
                 }
                 return true;
             }
 
             // 2. 若 LRU 未命中，去 LFU（高频数据区）查找
-            return _lfuPart->get(key, value);   
+            return _lfuPart->visit(key, hash, std::forward<Fn>(fn));
         }
 
         /**
-         * @brief 获取数据（直接返回值版本）
+         * @brief 写入已算好权重的条目
+         * 值只在同时需要写入两个分量时拷贝一次，其余情况按原本的值类别直接转发
          */
-        Value get(Key key) override
+        template<class V>
+        void putLocked(const Key& key, V&& value, size_t weight, uint64_t hash)
         {
-            Value value{};
-            get(key, value);
-            return value;
+            // 1. 尝试根据历史痕迹调整 LRU/LFU 的配额比例
+            checkGhostCaches(hash);
+
+            // 2. 如果该数据已经在 LFU 部分存在，LRU 部分存一份拷贝，LFU 部分同步更新
+            //    （LRU 部分的写入不影响 LFU 部分，因此可以先判断）
+            if(_lfuPart->contain(key, hash))
+            {
+                _lruPart->put(key, hash, static_cast<const Value&>(value), weight);
+                _lfuPart->put(key, hash, std::forward<V>(value), weight);
+                return;
+            }
+
+            // 3. 默认存入 LRU 部分（作为新晋数据）
+            _lruPart->put(key, hash, std::forward<V>(value), weight);
+        }
+
+        /**
+         * @brief 删除两个分量中的副本
+         */
+        template<class K>
+        void removeLocked(const K& key, uint64_t hash)
+        {
+            _lruPart->remove(key, hash);
+            _lfuPart->remove(key, hash);
+        }
+
+    private:
+        /**
+         * @brief 写入逻辑：两个 put 重载及其带哈希版本共用，权重在加锁前算好
+         */
+        template<class V>
+        void putImpl(const Key& key, uint64_t hash, V&& value)
+        {
+            size_t weight = _weigher(key, value);
+            std::unique_lock<CacheMutex> lock(_mutex);
+            putLocked(key, std::forward<V>(value), weight, hash);
         }
 
     private:
         size_t _capacity;           // 总容量上限
         size_t _transformThreshold; // 节点从 LRU 提升到 LFU 的阈值
+        Weigher _weigher;           // 条目权重函数（两个分量共用，写入前在锁外算好）
+        CacheMutex _mutex;          // 同时保护 T1 / B1 / T2 / B2；开启读缓冲时只涉及 T2 的读取（命中或确定未命中）取共享锁
         
         // ARC 的两个子引擎
-        std::unique_ptr<ArcLruPart<Key, Value>> _lruPart;
-        std::unique_ptr<ArcLfuPart<Key, Value>> _lfuPart;
+        std::unique_ptr<ArcLruPart<Key, Value, Weigher>> _lruPart;
+        std::unique_ptr<ArcLfuPart<Key, Value, Weigher>> _lfuPart;
     };
+
+    /**
+     * @brief 共享值模式的 ARC 缓存
+     * 两个分量中存放的都是 SharedValue<Value>：晋升到 LFU 部分时只多出一个句柄，
+     * 同一个大对象不会在 T1 / T2 中各存一份。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedArcCache = ArcCache<Key, SharedValue<Value>, Weigher>;
 }
 
 #endif
@@ -4,177 +4,227 @@
 #define __ARC_LFU_PART_HPP__
 
 #include <iostream>
-#include <unordered_map>
-#include <map>
 #include <memory>
 #include <vector>
 #include <list>
-#include <mutex>
+#include <utility>
 #include "../Common/ArcCacheNode.hpp"
+#include "../Common/ArcGhostList.hpp"
+#include "../Common/CacheHash.hpp"
+#include "../Common/CacheWeigher.hpp"
+#include "../Common/TagIndex.hpp"
+#include "../Common/ReadBuffer.hpp"
 
 namespace myCache
 {
     /**
      * @brief ArcLfuPart 类模板
      * 负责管理 ARC 算法中具有“高频访问”特征的数据。
-     * 内部采用 频率->节点链表 的映射结构，实现 O(1) 的频率平滑升级。
+     * 内部采用按频率升序串联的频率桶链，频率升级、淘汰与最小频率维护均为 O(1)。
+     * 容量按 Weigher 计算的权重累计，默认每个条目计 1。
+     * 本身不加锁，由 ArcCache 的锁保护。开启读缓冲（bufferedReads）后，ArcCache 可以在共享锁下
+     * 调用 visitBuffered：命中只查找并记录访问，升频攒批后由持有独占锁的一方调用 drainReadBuffer 统一回放。
+     * 供 ArcCache 使用的接口都带有 hash 参数（取值必须是 cacheHashOf<Key>(key)），T2 索引与 B2 幽灵列表共用这一个值；
+     * 不带哈希的 put / get / contain 供单独使用本部分时调用。
      */
-    template <class Key, class Value>
+    template <class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
     class ArcLfuPart
     {
     public:
         typedef ArcNode<Key, Value> NodeType;
         typedef std::shared_ptr<NodeType> NodePtr;
-        typedef std::unordered_map<Key, NodePtr> NodeMap;
-        // 使用 std::map 维护频率到节点的映射，map 默认按频率升序排列，方便找最小频率
-        typedef std::map<size_t, std::list<NodePtr>> FreqMap;
+        typedef std::list<NodePtr> FreqList;
+
+        /**
+         * @brief 频率桶：同一访问频率下的所有节点（队首最旧）
+         * 所有非空桶按频率升序串成一条链（FreqChain），参考 O(1) LFU 论文的结构：
+         * 频率 +1 时只需看相邻的下一个桶，最小频率就是链首，无需有序树。
+         */
+        struct FreqBucket
+        {
+            size_t freq;
+            FreqList nodes;
+        };
+        typedef std::list<FreqBucket> FreqChain;
+        typedef typename FreqChain::iterator BucketIter;
+
+        /**
+         * @brief 主缓存（T2）条目：节点指针 + 所在频率桶 + 节点在桶内链表中的位置
+         * 保存迭代器后，频率提升时可以直接定位并摘除节点，无需线性扫描链表
+         */
+        struct MainEntry
+        {
+            NodePtr node;
+            BucketIter bucket;
+            typename FreqList::iterator pos;
+        };
+
+        // 索引中存放完整的 MainEntry，Key 从其中的节点取出
+        struct EntryKeyOf
+        {
+            const Key& operator()(const MainEntry& entry) const { return entry.node->getKey(); }
+        };
+        typedef TagIndex<Key, MainEntry, EntryKeyOf> MainMap;
 
     private:
         /**
          * @brief 更新已存在节点的值并提升其频率
          */
-        bool updateExistingNode(NodePtr node, const Value& value)
+        template<class V>
+        bool updateExistingNode(MainEntry& entry, V&& value, size_t weight)
         {
-            node->setValue(value);
-            updateNodeFrequency(node);
+            NodePtr node = entry.node;
+            node->setValue(std::forward<V>(value));
+            _usedWeight = _usedWeight - node->_weight + weight;
+            node->_weight = weight;
+            updateNodeFrequency(entry);
+            // 新值更重时淘汰其他节点，但不淘汰刚写入的节点
+            while(_usedWeight > _capacity)
+            {
+                evictLeastFrequent(node);
+            }
             return true;
         }
 
+        /**
+         * @brief 在 pos 之前插入一个频率为 freq 的空桶
+         * 优先复用回收池中的桶（splice 只改指针），回收池为空时才真正分配
+         */
+        BucketIter insertBucket(BucketIter pos, size_t freq)
+        {
+            if(_spareBuckets.empty())
+            {
+                return _freqChain.insert(pos, FreqBucket{freq, FreqList()});
+            }
+            BucketIter bucket = _spareBuckets.begin();
+            _freqChain.splice(pos, _spareBuckets, bucket);
+            bucket->freq = freq;
+            return bucket;
+        }
+
+        /**
+         * @brief 将已空的桶从频率链上摘下，放入回收池
+         */
+        void recycleBucket(BucketIter bucket)
+        {
+            _spareBuckets.splice(_spareBuckets.end(), _freqChain, bucket);
+        }
+
         /**
          * @brief 添加新节点到 LFU 部分
          * 注意：在完整的 ARC 逻辑中，通常只有从 LRU 晋升过来的节点会进入这里
          */
-        bool addNewNode(const Key& key, const Value& value)
+        template<class V>
+        bool addNewNode(const Key& key, uint64_t hash, V&& value, size_t weight)
         {
-            if(_mainCache.size() >= _capacity)
+            while(!_mainCache.empty() && _usedWeight + weight > _capacity)
             {
-                // 容量满，根据 LFU 策略驱逐频率最低且最旧的节点
+                // 容量满，根据 LFU 策略驱逐频率最低且最旧的节点，直到能容纳新节点
                 evictLeastFrequent();
             }
-            NodePtr newNode = std::make_shared<NodeType>(key, value);
-            _mainCache[key] = newNode;
+            NodePtr newNode = std::make_shared<NodeType>(key, std::forward<V>(value));
+            newNode->_weight = weight;
+            _usedWeight += weight;
 
-            // 初始频率设为 1（或根据晋升时的实际频率设置）
-            if(_freqMap.find(1) == _freqMap.end())
+            // 初始频率为 1：频率 1 若存在必然是链首，否则在链首新建一个桶
+            BucketIter bucket = _freqChain.begin();
+            if(bucket == _freqChain.end() || bucket->freq != 1)
             {
-                _freqMap[1] = std::list<NodePtr>();
+                bucket = insertBucket(_freqChain.begin(), 1);
             }
-            _freqMap[1].push_front(newNode);
-            _minFreq = 1;
+            // 挂到桶的末尾（与频率提升时一致，队首始终是最旧的节点）
+            _mainCache.insert(MainEntry{newNode, bucket, bucket->nodes.insert(bucket->nodes.end(), newNode)}, hash);
 
             return true;
         }
 
         /**
          * @brief 频率提升逻辑
-         * 将节点从旧频率链表移动到新频率（freq + 1）链表
+         * 将节点从当前桶移动到相邻的 freq + 1 桶，全程 O(1)：
+         * 目标桶只可能是链上的下一个桶；节点用 splice 搬运，不会重新分配内存。
          */
-        void updateNodeFrequency(NodePtr node)
+        void updateNodeFrequency(MainEntry& entry)
         {
-            size_t oldFreq = node->getAccessCount();
-            node->incrementAccessCount(); // 访问计数 +1
-            size_t newFreq = node->getAccessCount();
+            entry.node->incrementAccessCount(); // 访问计数 +1
+            size_t newFreq = entry.node->getAccessCount();
 
-            // 1. 从原频率对应的 list 中移除
-            auto &oldList = _freqMap[oldFreq];
-            oldList.remove(node); // 注意：std::list::remove 是 O(n)，若追求极致性能可存储 list 迭代器
+            BucketIter oldBucket = entry.bucket;
+            BucketIter next = std::next(oldBucket);
 
-            // 2. 如果旧频率列表空了，清理它并更新全局最小频率指针
-            if(oldList.empty())
+            // 特例：节点独占当前桶且不存在 freq + 1 桶时，直接原地改桶的频率即可
+            if(oldBucket->nodes.size() == 1 && (next == _freqChain.end() || next->freq != newFreq))
             {
-                _freqMap.erase(oldFreq);
-                if(oldFreq == _minFreq)
-                {
-                    _minFreq = newFreq;
-                }
+                oldBucket->freq = newFreq;
+                return;
             }
 
-            // 3. 挂载到新频率列表的末尾（保持同频节点间的 LRU 顺序）
-            if(_freqMap.find(newFreq) == _freqMap.end())
+            if(next == _freqChain.end() || next->freq != newFreq)
             {
-                _freqMap[newFreq] = std::list<NodePtr>();
+                next = insertBucket(next, newFreq);
+            }
+
+            // 挂载到新频率桶的末尾（保持同频节点间的 LRU 顺序），迭代器在 splice 后依然有效
+            next->nodes.splice(next->nodes.end(), oldBucket->nodes, entry.pos);
+            entry.bucket = next;
+
+            // 旧桶空了就摘下回收，链首自动成为新的最小频率
+            if(oldBucket->nodes.empty())
+            {
+                recycleBucket(oldBucket);
             }
-            _freqMap[newFreq].push_back(node);
         }
 
         /**
          * @brief 淘汰逻辑：驱逐频率最低的节点并将其存入 Ghost (B2) 列表
+         * @param exclude 不允许被淘汰的节点（刚更新过的节点），为空表示不限制
          */
-        void evictLeastFrequent()
+        void evictLeastFrequent(const NodePtr& exclude = nullptr)
         {
-            if(_freqMap.empty())
+            if(_freqChain.empty())
                 return;
 
-            auto &minFreqList = _freqMap[_minFreq];
-            if(minFreqList.empty())
-                return;
-
-            // 取出最小频率链表中最旧的节点（队首）
-            NodePtr leastNode = minFreqList.front();
-            minFreqList.pop_front();
-
-            if(minFreqList.empty())
+            // 链首即最小频率桶，取出其中最旧的节点（队首）
+            BucketIter bucket = _freqChain.begin();
+            typename FreqList::iterator pos = bucket->nodes.begin();
+            if(*pos == exclude)
             {
-                _freqMap.erase(_minFreq);
-                if(!_freqMap.empty())
+                // 跳过被保护的节点：取同一桶中的下一个，桶里只有它时取下一个桶的队首
+                if(++pos == bucket->nodes.end())
                 {
-                    // 由于 std::map 是有序的，其 begin() 即为当前的最小频率
-                    _minFreq = _freqMap.begin()->first;
+                    if(++bucket == _freqChain.end())
+                        return;
+                    pos = bucket->nodes.begin();
                 }
             }
+            NodePtr leastNode = *pos;
+            bucket->nodes.erase(pos);
 
-            // --- 幽灵缓存处理 ---
-            if(_ghostCache.size() >= _ghostCapacity)
+            if(bucket->nodes.empty())
             {
-                removeOldestGhost();
+                recycleBucket(bucket);
             }
-            addToGhost(leastNode);
+
+            // --- 幽灵缓存处理：只记录 Key 的指纹和权重，值随节点一起释放 ---
+            _ghostList.add(leastNode->getKey(), leastNode->_weight);
 
             // 从物理主缓存映射中移除数据
+            _usedWeight -= leastNode->_weight;
             _mainCache.erase(leastNode->getKey());
         }
 
         /**
-         * @brief 从 Ghost 链表中物理断开节点
-         */
-        void removeFromGhost(NodePtr node)
-        {
-            if(!node->_prev.expired() && node->_next)
-            {
-                auto prev = node->_prev.lock();
-                prev->_next = node->_next;
-                node->_next->_prev = prev;
-                node->_next = nullptr;
-            }
-        }
-
-        /**
-         * @brief 将节点移入 Ghost 列表（B2），只保留元数据痕迹
+         * @brief 直接删除一个条目（不进入 Ghost 列表）
          */
-        void addToGhost(NodePtr node)
+        void eraseEntry(typename MainMap::iterator it)
         {
-            // 插入 Ghost 链表的尾部
-            node->_next = _ghostTail;
-            node->_prev = _ghostTail->_prev;
-            if(!_ghostTail->_prev.expired())
+            BucketIter bucket = it->mapped.bucket;
+            bucket->nodes.erase(it->mapped.pos);
+            if(bucket->nodes.empty())
             {
-                _ghostTail->_prev.lock()->_next = node;
-            }
-            _ghostTail->_prev = node;
-            _ghostCache[node->getKey()] = node;
-        }
-
-        /**
-         * @brief 彻底清理 Ghost 列表中最久远的记录
-         */
-        void removeOldestGhost()
-        {
-            NodePtr oldestGhost = _ghostHead->_next;
-            if(oldestGhost != _ghostTail)
-            {
-                removeFromGhost(oldestGhost);
-                _ghostCache.erase(oldestGhost->getKey());
+                recycleBucket(bucket);
             }
+            _usedWeight -= it->mapped.node->_weight;
+            _mainCache.erase(it);
         }
 
     public:
@@ -182,108 +232,195 @@ namespace myCache
          * @brief 构造函数
          * @param capacity LFU 部分的初始容量（ARC 运行时会动态调整此值）
          * @param transformThreshold 暂时未在内部显式使用，通常由外部控制
+         * @param bufferedReads 是否开启读缓冲：命中只记录访问，升频攒批进行
          */
-        explicit ArcLfuPart(size_t capacity, size_t transformThreshold)
+        explicit ArcLfuPart(size_t capacity, size_t transformThreshold, Weigher weigher = Weigher(),
+                            bool bufferedReads = false)
             : _capacity(capacity),
+              _usedWeight(0),
+              _weigher(weigher),
               _ghostCapacity(capacity),
               _transformThreshold(transformThreshold),
-              _minFreq(0),
-              _ghostHead(std::make_shared<NodeType>()),
-              _ghostTail(std::make_shared<NodeType>())
+              _ghostList(capacity),
+              _readBuffer(bufferedReads ? std::make_unique<ReadBuffer<NodeType>>() : nullptr)
+        {}
+
+        /**
+         * @brief 写入/更新接口
+         * value 按原本的值类别转发：左值拷贝一次，右值直接移动进节点
+         */
+        template<class V>
+        bool put(const Key& key, V&& value)
         {
-            _ghostHead->_next = _ghostTail;
-            _ghostTail->_prev = _ghostHead;
+            size_t weight = _weigher(key, value);
+            return put(key, _mainCache.hashOf(key), std::forward<V>(value), weight);
         }
 
         /**
-         * @brief 写入/更新接口
+         * @brief 写入/更新接口（带哈希与已算好的权重）
          */
-        bool put(Key key, Value value)
+        template<class V>
+        bool put(const Key& key, uint64_t hash, V&& value, size_t weight)
         {
             if(_capacity == 0)
                 return false;
-            std::lock_guard<std::mutex> lock(_mutex);
-            auto it = _mainCache.find(key);
+            drainReadBuffer(); // 先回放积攒的访问，也保证淘汰不会释放缓冲中的节点
+            auto it = _mainCache.find(key, hash);
+            if(weight > _capacity)
+            {
+                // 单个条目超过本部分的预算，无法存放：拒绝写入，同时丢弃旧值避免读到过期数据
+                if(it != _mainCache.end()) eraseEntry(it);
+                return false;
+            }
             if(it != _mainCache.end())
             {
-                return updateExistingNode(it->second, value);
+                return updateExistingNode(it->mapped, std::forward<V>(value), weight);
             }
-            return addNewNode(key, value);
+            return addNewNode(key, hash, std::forward<V>(value), weight);
         }
 
         /**
          * @brief 读取并提升节点频率
+         * @param key Key 或其异构查找类型（如 std::string Key 对应的 string_view）
          */
-        bool get(Key key, Value& value)
+        template<class K>
+        bool get(const K& key, Value& value)
         {
-            std::lock_guard<std::mutex> lock(_mutex);
-            auto it = _mainCache.find(key);
-            if(it != _mainCache.end())
+            return get(key, _mainCache.hashOf(key), value);
+        }
+
+        template<class K>
+        bool get(const K& key, uint64_t hash, Value& value)
+        {
+            return visit(key, hash, [&value](const Value& stored) { value = stored; });
+        }
+
+        /**
+         * @brief 免拷贝读取：命中时提升频率，并以 const 引用调用 fn(value)（调用方持有独占锁）
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, uint64_t hash, Fn&& fn)
+        {
+            auto it = _mainCache.find(key, hash);
+            if(it == _mainCache.end()) return false;
+            updateNodeFrequency(it->mapped);
+            fn(it->mapped.node->getValue());
+            return true;
+        }
+
+        /**
+         * @brief 读缓冲模式下的读取（调用方只需持有共享锁，且已开启读缓冲）
+         * 命中时以 const 引用调用 fn(value) 并记录访问，不修改任何结构
+         * @param shouldDrain 输出参数，条带已满时置为 true，调用方应尝试获取独占锁并调用 drainReadBuffer
+         */
+        template<class K, class Fn>
+        bool visitBuffered(const K& key, uint64_t hash, Fn&& fn, bool& shouldDrain)
+        {
+            auto it = _mainCache.find(key, hash);
+            if(it == _mainCache.end()) return false;
+            fn(it->mapped.node->getValue());
+            shouldDrain = _readBuffer->record(it->mapped.node.get());
+            return true;
+        }
+
+        /**
+         * @brief 回放读缓冲中记录的访问（调用方持有独占锁）
+         * 条目在索引中的位置会随插入删除移动，因此按节点的 Key 重新定位；
+         * 找到的条目不是同一个节点（期间已被删除或替换）时跳过。
+         */
+        void drainReadBuffer()
+        {
+            if(!_readBuffer) return;
+            _readBuffer->drain([this](NodeType* node)
             {
-                updateNodeFrequency(it->second);
-                value = it->second->getValue();
-                return true;
-            }
-            return false;
+                auto it = _mainCache.find(node->getKey());
+                if(it != _mainCache.end() && it->mapped.node.get() == node)
+                {
+                    updateNodeFrequency(it->mapped);
+                }
+            });
         }
 
+        bool bufferedReads() const { return _readBuffer != nullptr; }
+
         /**
          * @brief 检查节点是否存在于热缓存
          */
-        bool contain(Key key)
+        template<class K>
+        bool contain(const K& key)
         {
-            return _mainCache.find(key) != _mainCache.end();
+            return contain(key, _mainCache.hashOf(key));
+        }
+
+        template<class K>
+        bool contain(const K& key, uint64_t hash)
+        {
+            return _mainCache.find(key, hash) != _mainCache.end();
+        }
+
+        /**
+         * @brief 直接删除一个条目（不进入 Ghost 列表）
+         */
+        template<class K>
+        void remove(const K& key, uint64_t hash)
+        {
+            drainReadBuffer();
+            auto it = _mainCache.find(key, hash);
+            if(it != _mainCache.end()) eraseEntry(it);
         }
 
         /**
          * @brief 幽灵快查：在 B2 列表中检查是否存在访问记录
          * 如果命中，说明此 Key 曾是高频数据，这会触发 ARC 增大 LFU 部分的权重
          */
-        bool checkGhost(Key key)
+        bool checkGhost(uint64_t hash, size_t& weight)
         {
-            auto it = _ghostCache.find(key);
-            if(it != _ghostCache.end())
-            {
-                removeFromGhost(it->second);
-                _ghostCache.erase(it);
-                return true;
-            }
-            return false;
+            return _ghostList.removeWithHash(hash, weight);
+        }
+
+        /**
+         * @brief 只查询 Key 是否在淘汰痕迹中，不消费记录
+         */
+        bool hasGhost(uint64_t hash)
+        {
+            return _ghostList.containsWithHash(hash);
         }
 
         // --- 动态容量管理（供 ARC 主控逻辑调用） ---
 
-        void increaseCapacity() { _capacity++; }
+        void increaseCapacity(size_t delta = 1) { _capacity += delta; }
 
-        bool decreaseCapacity()
+        /**
+         * @brief 缩小容量，若当前存储超出新容量，需先驱逐节点
+         * @return 实际缩小的量（容量不足 delta 时只缩到 0），0 表示无法再缩
+         */
+        size_t decreaseCapacity(size_t delta = 1)
         {
-            if(_capacity <= 0)
-            {
-                _capacity = 0;
-                return false;
-            }
-            // 缩小容量时，若当前存储已满，需先驱逐一个节点
-            if(_mainCache.size() == _capacity)
+            if(_capacity == 0)
+                return 0;
+            if(delta > _capacity)
+                delta = _capacity;
+            drainReadBuffer(); // 淘汰前先回放，缓冲中不能残留即将释放的节点
+            _capacity -= delta;
+            while(_usedWeight > _capacity)
             {
                 evictLeastFrequent();   
             }
-            --_capacity;
-            return true;
+            return delta;
         }
         
     private:
-        size_t _capacity;           // LFU 主缓存（T2）容量
-        size_t _ghostCapacity;      // 幽灵记录（B2）最大容量
+        size_t _capacity;           // LFU 主缓存（T2）容量（权重预算）
+        size_t _usedWeight;         // 当前已占用的权重
+        Weigher _weigher;           // 条目权重函数
+        size_t _ghostCapacity;      // 幽灵记录（B2）最大容量（权重）
         size_t _transformThreshold; // 频率转换阈值
-        size_t _minFreq;            // 全局最小频率标识
-        std::mutex _mutex;
 
-        NodeMap _mainCache;         // Key -> 节点指针 (T2)
-        NodeMap _ghostCache;        // Key -> 节点指针 (B2，只存元数据)
-        FreqMap _freqMap;           // 频率分层索引
-        
-        NodePtr _ghostHead;         // Ghost 链表哨兵头
-        NodePtr _ghostTail;         // Ghost 链表哨兵尾
+        MainMap _mainCache;         // Key -> 节点指针及其频率链表位置 (T2)
+        ArcGhostList<Key> _ghostList; // 淘汰痕迹（B2，只存 Key 指纹）
+        FreqChain _freqChain;       // 按频率升序排列的非空频率桶链，链首即最小频率
+        FreqChain _spareBuckets;    // 已回收的空桶，供新频率复用
+        std::unique_ptr<ReadBuffer<NodeType>> _readBuffer; // 读缓冲，未开启时为空
     };
 }
 
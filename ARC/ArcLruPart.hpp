@@ -6,31 +6,53 @@
 #include <iostream>
 #include <memory>
 #include <vector>
-#include <unordered_map>
-#include <mutex>
+#include <utility>
 #include "../Common/ArcCacheNode.hpp"
+#include "../Common/ArcGhostList.hpp"
+#include "../Common/CacheHash.hpp"
+#include "../Common/CacheWeigher.hpp"
+#include "../Common/TagIndex.hpp"
 
 namespace myCache
 {
     /**
      * @brief ArcLruPart 负责管理 ARC 算法中的 LRU 逻辑部分（通常对应 T1 和 B1 列表）
+     * 容量按条目权重累计，权重由 ArcCache 用 Weigher 在锁外算好后传入（默认每个条目计 1）。
+     * 本身不加锁：T1 / B1 与 LFU 部分的 T2 / B2 由 ArcCache 的同一把锁保护。
+     * 只读接口（contain / hasGhost）不修改任何结构，可以由多个持有共享锁的线程同时调用。
+     * 各接口都带有 hash 参数，取值必须是 cacheHashOf<Key>(key)：ArcCache 每次操作只算一次哈希，
+     * T1 索引与 B1 幽灵列表共用这一个值。
      */
-    template<class Key, class Value>
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
     class ArcLruPart
     {
     public:
         typedef ArcNode<Key, Value> NodeType;
         typedef std::shared_ptr<NodeType> NodePtr;
-        typedef std::unordered_map<Key, NodePtr> NodeMap;
+
+        // 索引中只存节点指针，Key 直接从节点中取
+        struct NodeKeyOf
+        {
+            const Key& operator()(const NodePtr& node) const { return node->getKey(); }
+        };
+        typedef TagIndex<Key, NodePtr, NodeKeyOf> NodeMap;
 
     private:
         /**
          * @brief 更新已存在的节点：修改值并移动到 LRU 链表头部
          */
-        bool updateExistingNode(NodePtr node, const Value& value) 
+        template<class V>
+        bool updateExistingNode(NodePtr node, V&& value, size_t weight) 
         {
-            node->setValue(value);
+            node->setValue(std::forward<V>(value));
+            _usedWeight = _usedWeight - node->_weight + weight;
+            node->_weight = weight;
             moveToFront(node);
+            // 新值更重时从尾部淘汰（该节点已在头部，不会被自己淘汰）
+            while(_usedWeight > _capacity)
+            {
+                evictLeastRecent();
+            }
             return true;
         }
 
@@ -38,15 +60,18 @@ namespace myCache
          * @brief 添加全新的节点到 LRU 主缓存
          * 如果空间不足，会触发淘汰机制进入 Ghost 链表
          */
-        bool addNewNode(const Key& key, const Value& value)
+        template<class V>
+        bool addNewNode(const Key& key, uint64_t hash, V&& value, size_t weight)
         {
-            if(_mainCache.size() >= _capacity)
+            while(!_mainCache.empty() && _usedWeight + weight > _capacity)
             {
-                // 空间满，驱逐末尾节点（Least Recently Used）
+                // 空间满，驱逐末尾节点（Least Recently Used），直到能容纳新节点
                 evictLeastRecent();
             }
-            NodePtr newNode = std::make_shared<NodeType>(key, value);
-            _mainCache[key] = newNode;
+            NodePtr newNode = std::make_shared<NodeType>(key, std::forward<V>(value));
+            newNode->_weight = weight;
+            _usedWeight += weight;
+            _mainCache.insert(newNode, hash);
             addToFront(newNode);
             return true;
         }
@@ -97,13 +122,10 @@ namespace myCache
             removeFromMain(leastRecent);
             // 2. 从主哈希映射中移除（数据不再真正存储）
             _mainCache.erase(leastRecent->getKey());   
+            _usedWeight -= leastRecent->_weight;
 
-            // 3. 进入 Ghost 链表（只保留 Key 的访问痕迹）
-            if(_ghostCache.size() >= _ghostCapacity)
-            {
-                removeOldestGhost();
-            }
-            addToGhost(leastRecent);
+            // 3. 进入 Ghost 列表（只保留 Key 的指纹和权重，值随节点一起释放）
+            _ghostList.add(leastRecent->getKey(), leastRecent->_weight);
         }
 
         /**
@@ -120,144 +142,170 @@ namespace myCache
             }
         }
 
-        /**
-         * @brief 物理移除：断开节点在淘汰（Ghost）链表中的前后连接
-         */
-        void removeFromGhost(NodePtr node)
-        {
-            if(!node->_prev.expired() && node->_next)
-            {
-                auto prev = node->_prev.lock();
-                prev->_next = node->_next;
-                node->_next->_prev = prev;
-                node->_next = nullptr; 
-            }
-        }
-
-        /**
-         * @brief 存入幽灵链表：重置访问计数并存入 Ghost 映射
-         */
-        void addToGhost(NodePtr node)
-        {
-            node->_accessCount = 1;
-            // 挂载到 Ghost 链表头部
-            node->_next = _ghostHead->_next;
-            node->_prev = _ghostHead;
-            _ghostHead->_next->_prev = node;
-            _ghostHead->_next = node;
-
-            _ghostCache[node->getKey()] = node;
-        }
-
-        /**
-         * @brief 彻底销毁：从幽灵链表中删除最老的痕迹
-         */
-        void removeOldestGhost()
-        {
-            NodePtr leastRecent = _ghostTail->_prev.lock();
-            if(!leastRecent || leastRecent == _ghostHead)
-                return;
-
-            removeFromGhost(leastRecent);
-            _ghostCache.erase(leastRecent->getKey());
-        }
-
     public:
         /**
-         * @brief 构造函数：初始化主链表和幽灵链表的哨兵节点
+         * @brief 构造函数：初始化主链表的哨兵节点和幽灵列表
          */
         explicit ArcLruPart(size_t capacity, size_t transfromThreshold)
             : _capacity(capacity),
+              _usedWeight(0),
               _ghostCapacity(capacity),
               _transformThreshold(transfromThreshold),
+              _ghostList(capacity),
               _mainHead(std::make_shared<NodeType>()),
-              _mainTail(std::make_shared<NodeType>()),
-              _ghostHead(std::make_shared<NodeType>()),
-              _ghostTail(std::make_shared<NodeType>())
+              _mainTail(std::make_shared<NodeType>())
         {
             _mainHead->_next = _mainTail;
             _mainTail->_prev = _mainHead;
-            _ghostHead->_next = _ghostTail;
-            _ghostTail->_prev = _ghostHead;
+        }
+
+        /**
+         * @brief 逐个断开 _next 链接后再释放，避免长链表递归析构导致栈溢出
+         */
+        ~ArcLruPart()
+        {
+            NodePtr node = _mainHead;
+            while(node)
+            {
+                NodePtr next = std::move(node->_next);
+                node = std::move(next);
+            }
         }
         
         /**
          * @brief 外部写入接口
+         * value 按原本的值类别转发：左值拷贝一次，右值直接移动进节点
+         * @param weight 条目权重，由 ArcCache 在锁外算好
          * @return bool 是否成功操作（在 ARC 整体逻辑中可能触发晋升判断）
          */
-        bool put(Key key, Value value)
+        template<class V>
+        bool put(const Key& key, uint64_t hash, V&& value, size_t weight)
         {
             if(_capacity == 0) return false;
-            std::lock_guard<std::mutex> lock(_mutex);
-            auto it = _mainCache.find(key);
+            auto it = _mainCache.find(key, hash);
+            if(weight > _capacity)
+            {
+                // 单个条目超过本部分的预算，无法存放：拒绝写入，同时丢弃旧值避免读到过期数据
+                if(it != _mainCache.end()) eraseEntry(it);
+                return false;
+            }
             if(it != _mainCache.end())
             {
-                return updateExistingNode(it->second, value);
+                return updateExistingNode(it->mapped, std::forward<V>(value), weight);
             }
-            return addNewNode(key, value);
+            return addNewNode(key, hash, std::forward<V>(value), weight);
         }
 
         /**
          * @brief 外部读取接口
+         * @param key Key 或其异构查找类型（如 std::string Key 对应的 string_view）
          * @param shouldTransform 输出参数，告知外部调用者此节点是否由于访问频繁需要移动到 LFU 部分
          */
-        bool get(Key key, Value& value, bool& shouldTransform)
+        template<class K>
+        bool get(const K& key, uint64_t hash, Value& value, bool& shouldTransform)
         {
-            std::lock_guard<std::mutex> lock(_mutex);
-            auto it = _mainCache.find(key);
+            auto it = _mainCache.find(key, hash);
             if(it != _mainCache.end())
             {
-                shouldTransform = updateNodeAccess(it->second);
-                value = it->second->getValue();
+                shouldTransform = updateNodeAccess(it->mapped);
+                value = it->mapped->getValue();
                 return true;
             }
             return false;
         }
 
+        /**
+         * @brief 免拷贝读取：命中时以 const 引用调用 fn(value)
+         * shouldTransform 在调用 fn 之前就已写好，fn 可以据此决定是否需要留一份拷贝用于晋升
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, uint64_t hash, Fn&& fn, bool& shouldTransform)
+        {
+            auto it = _mainCache.find(key, hash);
+            if(it == _mainCache.end()) return false;
+            shouldTransform = updateNodeAccess(it->mapped);
+            fn(it->mapped->getValue());
+            return true;
+        }
+
+        /**
+         * @brief 检查节点是否存在于 LRU 主缓存（不影响访问顺序）
+         */
+        template<class K>
+        bool contain(const K& key, uint64_t hash)
+        {
+            return _mainCache.find(key, hash) != _mainCache.end();
+        }
+
+        /**
+         * @brief 直接删除一个条目（不进入 Ghost 列表）
+         */
+        template<class K>
+        void remove(const K& key, uint64_t hash)
+        {
+            auto it = _mainCache.find(key, hash);
+            if(it != _mainCache.end()) eraseEntry(it);
+        }
+
         /**
          * @brief 幽灵快查：检查 Key 是否在淘汰痕迹中
          * 如果命中，说明此 Key 之前被访问过但被踢出了，这会触发 ARC 的权重调整（增加 LRU 链表的配额）
          */
-        bool checkGhost(Key key)
+        bool checkGhost(uint64_t hash, size_t& weight)
         {
-            auto it = _ghostCache.find(key);
-            if(it != _ghostCache.end())
-            {
-                removeFromGhost(it->second);
-                _ghostCache.erase(it);
-                return true;
-            }
-            return false;
+            return _ghostList.removeWithHash(hash, weight);
+        }
+
+        /**
+         * @brief 只查询 Key 是否在淘汰痕迹中，不消费记录
+         */
+        bool hasGhost(uint64_t hash)
+        {
+            return _ghostList.containsWithHash(hash);
         }
 
         // --- 动态容量调整接口（ARC 算法的核心能力） ---
 
-        void increaseCapacity() { ++_capacity; }
+        void increaseCapacity(size_t delta = 1) { _capacity += delta; }
 
-        bool decreaseCapacity()
+        /**
+         * @brief 缩小容量，必要时先淘汰节点
+         * @return 实际缩小的量（容量不足 delta 时只缩到 0），0 表示无法再缩
+         */
+        size_t decreaseCapacity(size_t delta = 1)
         {
-            if(_capacity <= 0) { _capacity = 0; return false; }
-            if(_mainCache.size() == _capacity)
+            if(_capacity == 0) return 0;
+            if(delta > _capacity) delta = _capacity;
+            _capacity -= delta;
+            while(_usedWeight > _capacity)
             {
                 evictLeastRecent();
             }
-            --_capacity;
-            return true;
+            return delta;
+        }
+
+    private:
+        /**
+         * @brief 从链表和 map 中同时删除节点，并归还其权重
+         */
+        void eraseEntry(typename NodeMap::iterator it)
+        {
+            removeFromMain(it->mapped);
+            _usedWeight -= it->mapped->_weight;
+            _mainCache.erase(it);
         }
 
     private:
-        size_t _capacity;           // 当前 LRU 部分允许存储的数据量
-        size_t _ghostCapacity;      // 记录淘汰痕迹的最大数量
+        size_t _capacity;           // 当前 LRU 部分允许存储的数据量（权重预算）
+        size_t _usedWeight;         // 当前已占用的权重
+        size_t _ghostCapacity;      // 记录淘汰痕迹的最大数量（权重）
         size_t _transformThreshold; // 晋升为 LFU 节点的访问门槛
-        std::mutex _mutex;
 
-        NodeMap _mainCache;         // 热数据哈希映射
-        NodeMap _ghostCache;        // 淘汰痕迹哈希映射
+        NodeMap _mainCache;         // 热数据索引（标签分组索引）
+        ArcGhostList<Key> _ghostList; // 淘汰痕迹（B1，只存 Key 指纹）
 
         NodePtr _mainHead;          // LRU 双向链表头
         NodePtr _mainTail;          // LRU 双向链表尾
-        NodePtr _ghostHead;         // Ghost 双向链表头
-        NodePtr _ghostTail;         // Ghost 双向链表尾
     };
 }
 
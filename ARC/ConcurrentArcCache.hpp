@@ -0,0 +1,53 @@
+// ConcurrentArcCache.hpp
+
+#ifndef __CONCURRENT_ARC_CACHE_HPP__
+#define __CONCURRENT_ARC_CACHE_HPP__
+
+#include "ArcCache.hpp"
+#include "../Common/ConcurrentCache.hpp"
+#include "../Common/HashConcurrentCache.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 读路径无锁的 ARC 缓存
+     * 查找走 ConcurrentIndex，不取任何锁；T1 / T2 / 幽灵列表仍由一个 ArcCache 维护，
+     * 命中记入读缓冲，攒批回放成对 ArcCache 的访问，晋升与升频推迟到回放时进行（见 ConcurrentCache）。
+     * 晋升门槛按回放到的访问次数计算，丢弃的访问记录会让晋升略微滞后。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class ConcurrentArcCache : public ConcurrentCache<Key, Value, ArcCache, Weigher>
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 缓存总容量
+         * @param transformThreshold 晋升门槛（访问多少次后从 LRU 转入 LFU）
+         * @param weigher 权重函数，默认每个条目计 1
+         */
+        explicit ConcurrentArcCache(size_t capacity, size_t transformThreshold = 2, Weigher weigher = Weigher())
+            : ConcurrentCache<Key, Value, ArcCache, Weigher>(capacity, weigher, transformThreshold)
+        {}
+    };
+
+    /**
+     * @brief 分片的读路径无锁 ARC 缓存：每个分片一把写锁、一个读缓冲
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class HashConcurrentArcCache : public HashConcurrentCache<Key, Value, ArcCache, Weigher>
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 总缓存容量
+         * @param sliceNum 分片数量，不大于 0 时取硬件并发核心数，向上取整为 2 的幂
+         * @param transformThreshold 晋升门槛
+         * @param weigher 权重函数，默认每个条目计 1
+         */
+        HashConcurrentArcCache(size_t capacity, int sliceNum, size_t transformThreshold = 2, Weigher weigher = Weigher())
+            : HashConcurrentCache<Key, Value, ArcCache, Weigher>(capacity, sliceNum, weigher, transformThreshold)
+        {}
+    };
+}
+
+#endif
@@ -0,0 +1,190 @@
+// HashArcCache.hpp
+
+#ifndef __HASH_ARC_CACHE_HPP__
+#define __HASH_ARC_CACHE_HPP__
+
+#include "ArcCache.hpp"
+#include "../Common/ShardArray.hpp"
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <utility>
+
+namespace myCache
+{
+    /**
+     * @brief HashArcCache 模板类
+     * 与 HashLRUCache / HashLFUCache 相同的分片方式，每个分片是一个完整的 ArcCache（自带一把覆盖四个列表的锁）。
+     * 不同分片互不干扰，各自独立地在 LRU / LFU 之间自适应调整配额。
+     * Weigher 会传递给每个分片，容量（权重预算）按分片均分。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class HashArcCache
+    {
+    private:
+        /**
+         * @brief 哈希定位函数：与分片内部索引相同的混淆哈希（cacheHashOf），取最高几位选择分片，异构查找类型会被路由到同一个分片
+         * 同一个哈希值随后交给分片的带哈希接口，T1 / T2 索引与幽灵列表都不再重新计算
+         */
+        template<class K>
+        uint64_t Hash(const K& key)
+        {
+            return cacheHashOf<Key>(key);
+        }
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 总缓存容量（所有条目权重之和的上限）
+         * @param sliceNum 分片数量，不大于 0 时取硬件并发核心数，向上取整为 2 的幂
+         * @param transformThreshold 晋升门槛（访问多少次后从 LRU 转入 LFU）
+         * @param weigher 权重函数，默认每个条目计 1
+         * @param bufferedReads 是否为每个分片开启读缓冲（见 ArcCache）
+         */
+        HashArcCache(size_t capacity, int sliceNum, size_t transformThreshold = 2, Weigher weigher = Weigher(),
+                     bool bufferedReads = false)
+            : _capacity(capacity),
+              _router(sliceNum),
+              // 容量向上取整均分到各分片，分片连续存放在按缓存行对齐的数组中
+              _arcSliceCaches(_router.shardCount(), _router.perShard(capacity), transformThreshold, weigher, bufferedReads)
+        {}
+
+        void put(const Key& key, const Value& value)
+        {
+            uint64_t hash = Hash(key);
+            _arcSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, value);
+        }
+
+        void put(const Key& key, Value&& value)
+        {
+            uint64_t hash = Hash(key);
+            _arcSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, std::move(value));
+        }
+
+        bool get(const Key& key, Value& value)
+        {
+            uint64_t hash = Hash(key);
+            return _arcSliceCaches[_router.shardOf(hash)].getWithHash(key, hash, value);
+        }
+
+        Value get(const Key& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            uint64_t hash = Hash(key);
+            return _arcSliceCaches[_router.shardOf(hash)].getWithHash(key, hash, value);
+        }
+
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 批量读取：一次算好全部哈希，按分片分组，每个分片只加一次锁
+         * @param values 输出数组，长度不小于 count；命中的位置写入值，未命中的位置保持不变
+         * @param found 输出数组（可为空），记录每个位置是否命中
+         * @return 命中个数
+         */
+        size_t multiGet(const Key* keys, size_t count, Value* values, bool* found = nullptr)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = Hash(keys[i]);
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> offsets;
+            _router.group(hashes.data(), count, order, offsets);
+            if(found) std::fill(found, found + count, false);
+
+            size_t hits = 0;
+            for(size_t s = 0; s < _router.shardCount(); ++s)
+            {
+                size_t begin = offsets[s];
+                size_t n = offsets[s + 1] - begin;
+                if(n == 0) continue;
+                hits += _arcSliceCaches[s].visitBatchWithHash(keys, hashes.data(), order.data() + begin, n,
+                    [values, found](size_t i, const Value& stored)
+                    {
+                        values[i] = stored;
+                        if(found) found[i] = true;
+                    });
+            }
+            return hits;
+        }
+
+        /**
+         * @brief 批量写入：一次算好全部哈希，按分片分组，每个分片只加一次锁
+         */
+        void multiPut(const std::pair<Key, Value>* entries, size_t count)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = Hash(entries[i].first);
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> offsets;
+            _router.group(hashes.data(), count, order, offsets);
+
+            for(size_t s = 0; s < _router.shardCount(); ++s)
+            {
+                size_t begin = offsets[s];
+                size_t n = offsets[s + 1] - begin;
+                if(n == 0) continue;
+                _arcSliceCaches[s].putBatchWithHash(entries, hashes.data(), order.data() + begin, n);
+            }
+        }
+
+        /**
+         * @brief 免拷贝读取：在对应分片的锁内以 const 引用调用 fn(value)
+         * @return 是否命中
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            uint64_t hash = Hash(key);
+            return _arcSliceCaches[_router.shardOf(hash)].visitWithHash(key, hash, std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不触发幽灵调整也不影响访问状态）
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            uint64_t hash = Hash(key);
+            return _arcSliceCaches[_router.shardOf(hash)].containsWithHash(key, hash);
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        template<class K>
+        void remove(const K& key)
+        {
+            uint64_t hash = Hash(key);
+            _arcSliceCaches[_router.shardOf(hash)].removeWithHash(key, hash);
+        }
+
+    private:
+        size_t _capacity; // 总容量
+        ShardRouter _router; // 分片路由：分片数为 2 的幂
+        ShardArray<ArcCache<Key, Value, Weigher>> _arcSliceCaches;
+    };
+
+    /**
+     * @brief 共享值模式的分片 ARC 缓存
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedHashArcCache = HashArcCache<Key, SharedValue<Value>, Weigher>;
+}
+
+#endif
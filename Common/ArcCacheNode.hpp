@@ -4,12 +4,13 @@
 #define __ARC_CACHE_NODE_HPP__
 
 #include <memory>
+#include <utility>
 
 namespace myCache
 {
     // 前向声明，用于在 ArcNode 中定义友元类
-    template<class K, class V> class ArcLruPart;
-    template<class K, class V> class ArcLfuPart;
+    template<class K, class V, class W> class ArcLruPart;
+    template<class K, class V, class W> class ArcLfuPart;
 
     /**
      * @brief ArcNode 缓存节点类
@@ -19,15 +20,16 @@ namespace myCache
     class ArcNode
     {
         // 声明友元类，允许 ARC 的 LRU 部分和 LFU 部分直接访问私有成员，提高操作效率
-        template<class K, class V>
+        template<class K, class V, class W>
         friend class ArcLruPart;
-        template<class K, class V>
+        template<class K, class V, class W>
         friend class ArcLfuPart;
 
     private:
         Key _key;                 // 缓存的键
         Value _value;             // 缓存的值
         size_t _accessCount;      // 该节点被访问的次数（用于 LFU 逻辑判断）
+        size_t _weight;           // 该节点计入容量的权重（由 Weigher 计算）
 
         /**
          * 智能指针管理双向链表：
@@ -43,6 +45,7 @@ namespace myCache
          */
         ArcNode()
             : _accessCount(1),
+              _weight(0),
               _next(nullptr)
         {}
 
@@ -52,18 +55,19 @@ namespace myCache
          * @param value 值
          */
         ArcNode(Key key, Value value)
-            : _key(key),
-              _value(value),
+            : _key(std::move(key)),
+              _value(std::move(value)),
               _accessCount(1), // 节点创建时即为第一次访问
+              _weight(0),
               _next(nullptr)
         {}
 
-        Key getKey() const
+        const Key& getKey() const
         {
             return _key;
         }
         
-        Value getValue() const
+        const Value& getValue() const
         {
             return _value;
         }
@@ -78,6 +82,11 @@ namespace myCache
             _value = value;
         }
 
+        void setValue(Value&& value)
+        {
+            _value = std::move(value);
+        }
+
         /**
          * @brief 增加访问计数
          * 当节点被命中时调用，用于 ARC 算法判断是否将节点从 LRU 部分移动到 LFU 部分
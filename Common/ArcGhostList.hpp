@@ -0,0 +1,179 @@
+// ArcGhostList.hpp
+
+#ifndef __ARC_GHOST_LIST_HPP__
+#define __ARC_GHOST_LIST_HPP__
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include "CacheHash.hpp"
+#include "FlatIndex.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief ARC 幽灵列表（B1 / B2）
+     * ARC 的自适应只需要知道“某个 Key 最近是否被淘汰过”（以及它当时的权重），并不需要被淘汰的值。
+     * 因此这里只记录 Key 的 64 位指纹：
+     * - 一个 FIFO 队列按淘汰顺序保存 {指纹, 序号}，记录的权重总和超过容量时从队首丢弃最旧的痕迹；
+     * - 一个 指纹 -> {序号, 权重} 的开放寻址索引（FlatIndex）提供 O(1) 查询。
+     * 命中后只删除哈希表中的记录，队列中对应的条目随之失效，稍后在出队或压缩时顺带清理。
+     */
+    template<class Key>
+    class ArcGhostList
+    {
+    private:
+        struct QueueEntry
+        {
+            uint64_t fp;
+            uint64_t seq;
+        };
+
+        struct IndexEntry
+        {
+            uint64_t fp;
+            uint64_t seq;
+            size_t weight;
+        };
+
+        struct IndexKeyOf
+        {
+            const uint64_t& operator()(const IndexEntry& entry) const { return entry.fp; }
+        };
+        typedef FlatIndex<uint64_t, IndexEntry, IndexKeyOf> Index;
+
+        /**
+         * @brief 计算 Key 的指纹：在 CacheHash 的结果上再做一次 64 位混淆（murmur3 fmix64），
+         * 避免整数 Key 的恒等哈希导致指纹分布过于集中。
+         * CacheHash 对异构查找类型给出相同的哈希，因此 string_view 查到的指纹与 std::string 一致。
+         * 指纹即 cacheHashOf<Key>(key)，上层已经算过时可以直接使用带哈希的接口。
+         */
+        template<class K>
+        static uint64_t fingerprint(const K& key)
+        {
+            return cacheHashOf<Key>(key);
+        }
+
+        bool isLive(const QueueEntry& entry)
+        {
+            auto it = _index.find(entry.fp);
+            return it != _index.end() && it->mapped.seq == entry.seq;
+        }
+
+        /**
+         * @brief 失效条目超过有效条目时重建队列，保证队列长度与有效记录数同阶（均摊 O(1)）
+         */
+        void compactIfNeeded()
+        {
+            if(_queue.size() <= 2 * _index.size() + 16) return;
+            std::deque<QueueEntry> live;
+            for(const QueueEntry& entry : _queue)
+            {
+                if(isLive(entry)) live.push_back(entry);
+            }
+            _queue.swap(live);
+        }
+
+    public:
+        /**
+         * @param capacity 记录的淘汰痕迹权重总和上限（按条目计数时即条目数上限）
+         */
+        explicit ArcGhostList(size_t capacity)
+            : _capacity(capacity),
+              _usedWeight(0),
+              _nextSeq(0)
+        {}
+
+        /**
+         * @brief 记录一次淘汰；超出容量时丢弃最旧的痕迹
+         */
+        void add(const Key& key, size_t weight = 1)
+        {
+            if(weight > _capacity) return;
+            uint64_t fp = fingerprint(key);
+            auto it = _index.find(fp);
+            if(it != _index.end())
+            {
+                _usedWeight -= it->mapped.weight; // 旧记录被覆盖，其队列条目随之失效
+                it->mapped.seq = _nextSeq;
+                it->mapped.weight = weight;
+            }
+            else
+            {
+                _index.insert(IndexEntry{fp, _nextSeq, weight});
+            }
+            _queue.push_back(QueueEntry{fp, _nextSeq++});
+            _usedWeight += weight;
+
+            while(_usedWeight > _capacity)
+            {
+                QueueEntry oldest = _queue.front();
+                _queue.pop_front();
+                auto oldIt = _index.find(oldest.fp);
+                if(oldIt != _index.end() && oldIt->mapped.seq == oldest.seq)
+                {
+                    _usedWeight -= oldIt->mapped.weight;
+                    _index.erase(oldIt);
+                }
+            }
+            compactIfNeeded();
+        }
+
+        /**
+         * @brief 查询并消费一条淘汰痕迹
+         * @param weight 命中时传出该条目被淘汰时的权重
+         * @return 命中返回 true（同时删除该记录），否则返回 false
+         */
+        template<class K>
+        bool remove(const K& key, size_t& weight)
+        {
+            return removeWithHash(fingerprint(key), weight);
+        }
+
+        /**
+         * @brief 按指纹消费一条淘汰痕迹，hash 必须等于 cacheHashOf<Key>(key)
+         */
+        bool removeWithHash(uint64_t hash, size_t& weight)
+        {
+            auto it = _index.find(hash);
+            if(it == _index.end()) return false;
+            weight = it->mapped.weight;
+            _usedWeight -= weight;
+            _index.erase(it);
+            compactIfNeeded();
+            return true;
+        }
+
+        template<class K>
+        bool remove(const K& key)
+        {
+            size_t weight;
+            return remove(key, weight);
+        }
+
+        /**
+         * @brief 只查询是否存在淘汰痕迹，不消费记录，也不修改任何结构
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            return containsWithHash(fingerprint(key));
+        }
+
+        bool containsWithHash(uint64_t hash)
+        {
+            return _index.find(hash) != _index.end();
+        }
+
+        size_t size() const { return _index.size(); }
+
+    private:
+        size_t _capacity;                             // 痕迹权重总和上限
+        size_t _usedWeight;                           // 当前有效痕迹的权重总和
+        std::deque<QueueEntry> _queue;                // 按淘汰顺序保存的 {指纹, 序号}
+        Index _index;                                 // 指纹 -> {最新序号, 权重}
+        uint64_t _nextSeq;                            // 下一次写入的序号
+    };
+}
+
+#endif
@@ -0,0 +1,156 @@
+// CacheHash.hpp
+
+#ifndef __CACHE_HASH_HPP__
+#define __CACHE_HASH_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace myCache
+{
+    /**
+     * @brief 缓存行大小，用于按缓存行对齐、隔离被多线程频繁写入的数据
+     * 不直接使用 std::hardware_destructive_interference_size：它的值随编译器版本与 -mtune 变化，
+     * 放在头文件中会让同一个类型在不同编译单元里布局不一致（GCC 对此有 -Winterference-size 警告）。
+     */
+    inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * @brief 各缓存内部哈希表统一使用的哈希函数，默认就是 std::hash<Key>
+     * 为某种 Key 特化并声明 is_transparent 后，就可以用“不必构造 Key”的类型直接查找。
+     */
+    template<class Key>
+    struct CacheHash : std::hash<Key> {};
+
+    /**
+     * @brief 各缓存内部哈希表统一使用的相等比较，默认就是 std::equal_to<Key>
+     */
+    template<class Key>
+    struct CacheKeyEqual : std::equal_to<Key> {};
+
+    /**
+     * @brief std::string Key 的透明哈希
+     * 统一按 string_view 计算，标准保证与 std::hash<std::string> 对相同内容的结果一致，
+     * 因此 std::string / std::string_view / const char* 落到同一个桶（以及同一个分片）。
+     */
+    template<>
+    struct CacheHash<std::string>
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view key) const
+        {
+            return std::hash<std::string_view>{}(key);
+        }
+    };
+
+    template<>
+    struct CacheKeyEqual<std::string>
+    {
+        using is_transparent = void;
+
+        bool operator()(std::string_view lhs, std::string_view rhs) const
+        {
+            return lhs == rhs;
+        }
+    };
+
+    /**
+     * @brief 64 位哈希混淆（murmur3 fmix64）
+     * std::hash 对整数是恒等映射，直接取低位做下标或指纹时分布很差，这里先打散所有位
+     */
+    inline uint64_t mixHash(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /**
+     * @brief Key 的混淆哈希：CacheHash 之后再做一次 mixHash
+     * 与 TagIndex 默认使用的哈希完全相同，分片路由算出的值可以直接交给分片内部的索引复用
+     */
+    template<class Key, class K>
+    inline uint64_t cacheHashOf(const K& key)
+    {
+        return mixHash(static_cast<uint64_t>(CacheHash<Key>{}(key)));
+    }
+
+    /**
+     * @brief 分片路由：分片数向上取整为 2 的幂，用混淆哈希的最高几位选择分片
+     * 取模换成移位，省掉每次操作的一次除法；
+     * 最高位与 TagIndex 使用的低位（标签与组号）互不重叠，分片内部索引的分布不受路由影响。
+     */
+    class ShardRouter
+    {
+    public:
+        /**
+         * @param shardCount 期望的分片数，不大于 0 时取硬件并发核心数，最终向上取整为 2 的幂
+         */
+        explicit ShardRouter(int shardCount)
+            : _bits(0)
+        {
+            size_t wanted = shardCount > 0 ? static_cast<size_t>(shardCount) : std::thread::hardware_concurrency();
+            while((size_t(1) << _bits) < wanted) ++_bits;
+        }
+
+        size_t shardCount() const { return size_t(1) << _bits; }
+
+        /**
+         * @brief 把总量（容量、历史队列长度等）均分到每个分片，向上取整，确保总量不低于设定值
+         */
+        size_t perShard(size_t total) const
+        {
+            return (total >> _bits) + ((total & (shardCount() - 1)) != 0 ? 1 : 0);
+        }
+
+        size_t shardOf(uint64_t hash) const
+        {
+            return _bits == 0 ? 0 : static_cast<size_t>(hash >> (64 - _bits));
+        }
+
+        /**
+         * @brief 把一批哈希按分片分组（计数排序，组内保持原顺序），供批量接口每个分片只加一次锁
+         * 结束后分片 s 的各个下标依次为 order[offsets[s]] .. order[offsets[s + 1] - 1]
+         */
+        void group(const uint64_t* hashes, size_t count, std::vector<uint32_t>& order, std::vector<uint32_t>& offsets) const
+        {
+            offsets.assign(shardCount() + 1, 0);
+            for(size_t i = 0; i < count; ++i) ++offsets[shardOf(hashes[i]) + 1];
+            for(size_t s = 0; s < shardCount(); ++s) offsets[s + 1] += offsets[s];
+
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            order.resize(count);
+            for(size_t i = 0; i < count; ++i) order[cursor[shardOf(hashes[i])]++] = static_cast<uint32_t>(i);
+        }
+
+    private:
+        unsigned _bits; // log2(分片数)
+    };
+
+    /**
+     * @brief 判断 K 能否作为 Key 的“免构造查找类型”
+     * 目前只有 std::string Key 支持：任何能隐式转换为 string_view 的类型（string_view、const char*、字面量）。
+     */
+    template<class Key, class K>
+    struct IsLookupKey : std::false_type {};
+
+    template<class K>
+    struct IsLookupKey<std::string, K>
+        : std::integral_constant<bool, !std::is_same<typename std::decay<K>::type, std::string>::value
+                                       && std::is_convertible<const K&, std::string_view>::value> {};
+
+    template<class Key, class K>
+    using EnableIfLookupKey = typename std::enable_if<IsLookupKey<Key, K>::value, int>::type;
+}
+
+#endif
@@ -18,9 +18,15 @@ namespace myCache
 
         /**
          * @brief 存入缓存
-         * 将键值对(Key-Value)放入缓存中
+         * 将键值对(Key-Value)放入缓存中，值会被拷贝一份保存
          */
-        virtual void put(Key key, Value value) = 0;
+        virtual void put(const Key& key, const Value& value) = 0;
+
+        /**
+         * @brief 存入缓存（右值版本）
+         * 值直接移动进缓存节点，调用方不再需要它时（临时对象、std::move）可以省去一次拷贝
+         */
+        virtual void put(const Key& key, Value&& value) = 0;
 
         /**
          * @brief 读取缓存
@@ -28,14 +34,14 @@ namespace myCache
          * @param value 如果找到，通过此参数传出结果
          * @return 命中返回 true，未找到返回 false
          */
-        virtual bool get(Key key, Value& value) = 0;
+        virtual bool get(const Key& key, Value& value) = 0;
 
         /**
          * @brief 读取缓存
          * @param key 要查找的键
          * @return 直接返回对应的值；若找不到，则返回该类型的默认值
          */
-        virtual Value get(Key key) = 0;
+        virtual Value get(const Key& key) = 0;
     };
 }
 
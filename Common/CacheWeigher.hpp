@@ -0,0 +1,62 @@
+// CacheWeigher.hpp
+
+#ifndef __CACHE_WEIGHER_HPP__
+#define __CACHE_WEIGHER_HPP__
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace myCache
+{
+    /**
+     * @brief 默认权重函数：每个条目权重为 1
+     * 此时容量即“条目数上限”，与各缓存原先按条目计数的行为完全一致。
+     */
+    template<class Key, class Value>
+    struct UnitWeigher
+    {
+        size_t operator()(const Key&, const Value&) const { return 1; }
+    };
+
+    namespace detail
+    {
+        // 判断类型是否提供 size() 与 value_type（如 std::string / std::vector），用于估算堆上占用
+        template<class T, class = void>
+        struct HasSize : std::false_type {};
+
+        template<class T>
+        struct HasSize<T, decltype(void(std::declval<const T&>().size()), void(sizeof(typename T::value_type)))>
+            : std::true_type {};
+
+        template<class T>
+        size_t heapBytes(const T& obj, std::true_type)
+        {
+            return obj.size() * sizeof(typename T::value_type);
+        }
+
+        template<class T>
+        size_t heapBytes(const T&, std::false_type)
+        {
+            return 0;
+        }
+    }
+
+    /**
+     * @brief 按字节估算的权重函数
+     * 权重 = Key 与 Value 的对象大小 + 二者通过 size() 暴露的连续内容大小。
+     * 配合以字节为单位的容量使用，可以直接按内存预算来限制缓存。
+     */
+    template<class Key, class Value>
+    struct ByteWeigher
+    {
+        size_t operator()(const Key& key, const Value& value) const
+        {
+            return sizeof(Key) + sizeof(Value)
+                 + detail::heapBytes(key, detail::HasSize<Key>())
+                 + detail::heapBytes(value, detail::HasSize<Value>());
+        }
+    };
+}
+
+#endif
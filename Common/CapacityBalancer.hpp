@@ -0,0 +1,160 @@
+// CapacityBalancer.hpp
+
+#ifndef __CAPACITY_BALANCER_HPP__
+#define __CAPACITY_BALANCER_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "CacheHash.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 分片之间的容量再分配：按各分片的“未命中压力”在分片之间挪动配额，总预算保持不变
+     * 固定均分时，Key 分布倾斜会让热分片反复淘汰而冷分片空着一半，整体命中率明显低于同容量的不分片缓存。
+     *
+     * 压力只统计“重复未命中”：每个分片有一张直接映射的指纹表，记录最近未命中过的 Key 的哈希指纹。
+     * 未命中时若指纹已在表中，说明这个 Key 不久前刚被请求过、如今已被淘汰——容量再大一些本可以命中；
+     * 第一次出现的 Key（冷启动未命中）不计入压力，否则只会把容量挪给访问量大而不是真正缺容量的分片。
+     *
+     * 某个分片的压力每累积 REBALANCE_INTERVAL 次就尝试再分配一次（已有线程在做时直接跳过）：
+     * 本轮压力明显高于平均的分片为接收方，明显低于平均的分片各让出一步配额（不低于初始配额的 1/4），
+     * 让出的总量轮流分给接收方。每轮只挪一小步，分片缩到装不下自己的工作集时会重新出现压力，把配额要回去。
+     * 线程安全：recordMiss 可并发调用；rebalance 由内部互斥量串行化，调用方不能持有任何分片的锁。
+     */
+    class CapacityBalancer
+    {
+    public:
+        static constexpr uint64_t REBALANCE_INTERVAL = 256; // 单个分片累积多少次压力触发一次再分配
+        static constexpr size_t MAX_SHADOW_SLOTS = 1 << 16; // 每个分片指纹表的槽位上限
+
+    private:
+        struct alignas(CACHE_LINE_SIZE) ShardState
+        {
+            std::atomic<uint64_t> pressure;                 // 累计重复未命中次数
+            std::unique_ptr<std::atomic<uint32_t>[]> seen;  // 最近未命中 Key 的指纹，0 表示空
+            size_t seenMask;
+
+            ShardState() : pressure(0), seenMask(0) {}
+        };
+
+    public:
+        /**
+         * @param shardCount 分片数
+         * @param shardCapacity 每个分片的初始配额（权重）
+         */
+        CapacityBalancer(size_t shardCount, size_t shardCapacity)
+            : _shards(new ShardState[shardCount]),
+              _shardCount(shardCount),
+              _capacities(shardCount, shardCapacity),
+              _lastPressure(shardCount, 0),
+              _minCapacity(std::max<size_t>(1, shardCapacity / 4)),
+              _step(std::max<size_t>(1, shardCapacity / 16))
+        {
+            // 指纹表覆盖约 4 倍初始配额的访问距离：分片长到初始配额的几倍时仍能识别出缺容量的未命中
+            size_t slots = 1;
+            while(slots < shardCapacity * 4 && slots < MAX_SHADOW_SLOTS) slots <<= 1;
+            for(size_t i = 0; i < shardCount; ++i)
+            {
+                _shards[i].seen.reset(new std::atomic<uint32_t>[slots]);
+                for(size_t j = 0; j < slots; ++j) _shards[i].seen[j].store(0, std::memory_order_relaxed);
+                _shards[i].seenMask = slots - 1;
+            }
+        }
+
+        CapacityBalancer(const CapacityBalancer&) = delete;
+        CapacityBalancer& operator=(const CapacityBalancer&) = delete;
+
+        /**
+         * @brief 记录一次未命中
+         * @param hash Key 的混淆哈希（与分片路由使用的相同）；最高位用于选分片，这里只用低 32 位和中间的位
+         * @return 是否到了再分配的时机，为 true 时调用方应在不持有分片锁的情况下调用 rebalance
+         */
+        bool recordMiss(size_t shard, uint64_t hash)
+        {
+            ShardState& state = _shards[shard];
+            uint32_t fingerprint = static_cast<uint32_t>(hash) | 1;
+            std::atomic<uint32_t>& slot = state.seen[static_cast<size_t>(hash >> 32) & state.seenMask];
+            if(slot.load(std::memory_order_relaxed) != fingerprint)
+            {
+                slot.store(fingerprint, std::memory_order_relaxed); // 第一次出现（或被挤掉后再次出现）：只记下指纹
+                return false;
+            }
+            uint64_t pressure = state.pressure.fetch_add(1, std::memory_order_relaxed) + 1;
+            return pressure % REBALANCE_INTERVAL == 0;
+        }
+
+        /**
+         * @brief 按上一轮以来的压力挪动配额；先调用 setCapacity 缩小让出方，再放大接收方
+         * @param setCapacity 形如 void(size_t shard, size_t capacity) 的回调
+         */
+        template<class Fn>
+        void rebalance(Fn&& setCapacity)
+        {
+            std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+            if(!lock.owns_lock()) return; // 其他线程正在再分配
+
+            std::vector<uint64_t> delta(_shardCount);
+            uint64_t total = 0;
+            for(size_t i = 0; i < _shardCount; ++i)
+            {
+                uint64_t pressure = _shards[i].pressure.load(std::memory_order_relaxed);
+                delta[i] = pressure - _lastPressure[i];
+                _lastPressure[i] = pressure;
+                total += delta[i];
+            }
+
+            // 与平均值比较时两边同乘分片数，避免整数除法丢精度；高于平均 1.5 倍接收，低于一半让出
+            std::vector<size_t> receivers;
+            std::vector<size_t> donors;
+            for(size_t i = 0; i < _shardCount; ++i)
+            {
+                uint64_t scaled = delta[i] * _shardCount;
+                if(delta[i] > 0 && scaled * 2 > total * 3) receivers.push_back(i);
+                else if(scaled * 2 < total && _capacities[i] >= _minCapacity + _step) donors.push_back(i);
+            }
+            if(receivers.empty() || donors.empty()) return;
+            std::sort(receivers.begin(), receivers.end(), [&delta](size_t a, size_t b) { return delta[a] > delta[b]; });
+
+            for(size_t donor : donors)
+            {
+                _capacities[donor] -= _step;
+                setCapacity(donor, _capacities[donor]);
+            }
+            for(size_t i = 0; i < donors.size(); ++i)
+            {
+                size_t receiver = receivers[i % receivers.size()];
+                _capacities[receiver] += _step;
+            }
+            for(size_t receiver : receivers)
+            {
+                setCapacity(receiver, _capacities[receiver]);
+            }
+        }
+
+        /**
+         * @brief 分片当前的配额（只用于观察）
+         */
+        size_t capacityOf(size_t shard)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _capacities[shard];
+        }
+
+    private:
+        std::unique_ptr<ShardState[]> _shards; // 每个分片的压力计数与指纹表，各占独立的缓存行
+        size_t _shardCount;
+        std::vector<size_t> _capacities;       // 各分片当前配额，总和恒等于初始总预算
+        std::vector<uint64_t> _lastPressure;   // 上一轮再分配时各分片的累计压力
+        size_t _minCapacity;                   // 让出配额的下限：初始配额的 1/4
+        size_t _step;                          // 每轮每个让出方挪动的配额：初始配额的 1/16
+        std::mutex _mutex;                     // 串行化再分配
+    };
+}
+
+#endif
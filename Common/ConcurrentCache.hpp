@@ -0,0 +1,371 @@
+// ConcurrentCache.hpp
+
+#ifndef __CONCURRENT_CACHE_HPP__
+#define __CONCURRENT_CACHE_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "CachePolicy.hpp"
+#include "CacheHash.hpp"
+#include "CacheWeigher.hpp"
+#include "ConcurrentIndex.hpp"
+#include "EpochReclaimer.hpp"
+#include "ReadBuffer.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 读路径无锁的缓存外壳：淘汰顺序由一个现有的淘汰策略（LRUCache、ArcCache 等）决定
+     * - 读（get / visit / contains）：在 EpochGuard 保护下查找 ConcurrentIndex，不取任何锁；
+     *   命中时把条目指针记入 ReadBuffer，攒够一批后由抢到写锁的线程统一回放给淘汰策略（相当于一次 get），
+     *   LRU 链表调整、ARC 的晋升与升频都推迟到回放时进行。
+     *   每个条目记着上一次被记录时的回放轮次（_stamp），同一轮内的重复命中只读两个原子变量、不再写缓冲，
+     *   热点条目的读因此基本不产生原子读-改-写；
+     * - 写（put / remove）：由一把写锁串行化，条目是不可变的，更新时整条替换；
+     *   淘汰策略中存放的不是值，而是指向条目的引用（EntryRef），策略丢掉最后一个引用时（淘汰、覆盖、删除）
+     *   条目从索引摘下并交给 EpochDomain，等所有可能看到它的读者离开后再释放。
+     * 写锁内直接调用淘汰策略的不加锁接口，淘汰策略自身的锁不参与；哈希只在入口算一次，
+     * 索引、淘汰策略与回放都使用条目中保存的同一个值。
+     * 回放与释放的先后由 EpochDomain 的回收回调保证：释放前先取走读缓冲中的全部记录，缓冲里不会留下悬空指针。
+     * 缓冲是有损的，淘汰顺序是对淘汰策略的近似；读多写少、希望读吞吐量随线程数增长时使用，
+     * 写吞吐量受单把写锁限制，需要时使用分片版本 HashConcurrentCache。
+     * @tparam Policy 淘汰策略模板，形如 Policy<Key, EntryRef, Weigher>，构造参数为 (capacity, 额外参数..., weigher)；
+     *                需提供不加锁的 visitLocked(key, hash, fn)、putLocked(key, value, weight, hash)、
+     *                removeLocked(key, hash)，并把 ConcurrentCache 声明为友元（见 LRUCache、ArcCache）
+     */
+    template<class Key, class Value, template<class, class, class> class Policy, class Weigher = UnitWeigher<Key, Value>>
+    class ConcurrentCache : public CachePolicy<Key, Value>
+    {
+        /**
+         * @brief 缓存条目：Key 与值发布后不再修改；_refs 与 _linked 只由写者访问
+         */
+        struct Entry : ConcurrentIndexHook<Entry>
+        {
+            const Key _key;
+            const Value _value;
+            std::atomic<uint32_t> _stamp; // 最近一次记入读缓冲时的回放轮次，0 表示从未记录
+            size_t _refs;   // 淘汰策略中持有的引用数
+            bool _linked;   // 是否仍挂在索引上
+
+            template<class V>
+            Entry(const Key& key, V&& value)
+                : _key(key), _value(std::forward<V>(value)), _stamp(0), _refs(0), _linked(false)
+            {}
+        };
+
+        struct EntryKeyOf
+        {
+            const Key& operator()(const Entry& entry) const { return entry._key; }
+        };
+        typedef ConcurrentIndex<Key, Entry, EntryKeyOf> NodeMap;
+
+    public:
+        /**
+         * @brief 淘汰策略中存放的“值”：指向条目的计数引用
+         * 只在写锁内被拷贝和析构，计数不需要原子操作；最后一个引用析构时通知所属缓存回收条目。
+         */
+        class EntryRef
+        {
+        public:
+            EntryRef() : _entry(nullptr), _owner(nullptr) {}
+            EntryRef(Entry* entry, ConcurrentCache* owner) : _entry(entry), _owner(owner) { ++_entry->_refs; }
+            EntryRef(const EntryRef& other) : _entry(other._entry), _owner(other._owner) { if(_entry) ++_entry->_refs; }
+            EntryRef(EntryRef&& other) noexcept : _entry(other._entry), _owner(other._owner) { other._entry = nullptr; }
+            ~EntryRef() { if(_entry && --_entry->_refs == 0) _owner->release(_entry); }
+
+            EntryRef& operator=(EntryRef other) noexcept
+            {
+                std::swap(_entry, other._entry);
+                std::swap(_owner, other._owner);
+                return *this;
+            }
+
+            const Value& value() const { return _entry->_value; }
+
+        private:
+            Entry* _entry;
+            ConcurrentCache* _owner;
+        };
+
+        /**
+         * @brief 淘汰策略使用的权重函数：按引用指向的值计算
+         */
+        struct EntryWeigher
+        {
+            Weigher weigher;
+            size_t operator()(const Key& key, const EntryRef& ref) const { return weigher(key, ref.value()); }
+        };
+
+        typedef Policy<Key, EntryRef, EntryWeigher> PolicyCache;
+
+    private:
+        /**
+         * @brief 淘汰策略丢掉了条目的最后一个引用（调用方持有写锁）
+         * 只从索引摘下并登记，退休放到写操作结束时进行：这里可能正处在淘汰策略或回收回调的内部
+         */
+        void release(Entry* entry)
+        {
+            if(entry->_linked)
+            {
+                _nodeMap.erase(entry);
+                entry->_linked = false;
+            }
+            _released.push_back(entry);
+        }
+
+        /**
+         * @brief 退休本次写操作中释放的条目（调用方持有写锁）
+         * retire 可能触发回收，回收回调中的回放又可能释放新的条目，因此循环到没有为止
+         */
+        void retireReleased()
+        {
+            while(!_released.empty())
+            {
+                std::vector<Entry*> batch;
+                batch.swap(_released);
+                for(Entry* entry : batch) _domain.retire(entry);
+            }
+        }
+
+        /**
+         * @brief 把读缓冲中的访问回放给淘汰策略（调用方持有写锁）
+         * 已从索引摘下的条目跳过；回放相当于对淘汰策略的一次 get，可能引发 ARC 晋升等结构调整。
+         * 使用条目中保存的哈希，不重新计算；回放后进入下一轮，此后的命中重新记录
+         */
+        void drainReadBuffer()
+        {
+            _readBuffer.drainConcurrent([this](Entry* entry)
+            {
+                if(entry->_linked) _policy->visitLocked(entry->_key, entry->hash, [](const EntryRef&) {});
+            });
+            uint32_t tick = _tick.load(std::memory_order_relaxed) + 1;
+            _tick.store(tick ? tick : 1, std::memory_order_relaxed); // 跳过 0，新条目的第一次命中总会记录
+        }
+
+        /**
+         * @brief 读缓冲某个条带已满：抢得到写锁就顺手回放，抢不到说明有其他线程在写，交给它处理
+         */
+        void tryDrainReadBuffer()
+        {
+            std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+            if(!lock.owns_lock()) return;
+            drainReadBuffer();
+            retireReleased();
+        }
+
+    public:
+        /**
+         * @brief 初始化缓存
+         * @param capacity 缓存容量上限（所有条目权重之和的上限），交给淘汰策略
+         * @param weigher 权重函数，默认每个条目计 1
+         * @param policyArgs 淘汰策略在容量与权重函数之间的其余构造参数（如 ArcCache 的晋升门槛）
+         */
+        template<class... PolicyArgs>
+        explicit ConcurrentCache(size_t capacity, Weigher weigher = Weigher(), PolicyArgs... policyArgs)
+            : _nodeMap(_domain, std::is_same<Weigher, UnitWeigher<Key, Value>>::value ? capacity : 0),
+              _weigher(weigher),
+              _policy(std::make_unique<PolicyCache>(capacity, policyArgs..., EntryWeigher{weigher})),
+              _tick(1)
+        {
+            // 回收前先取走读缓冲中的记录：能看到待释放条目的读者都已离开，它们的记录此时都已写入缓冲
+            _domain.setReclaimHook([this]() { drainReadBuffer(); });
+        }
+
+        ConcurrentCache(const ConcurrentCache&) = delete;
+        ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+
+        /**
+         * @brief 析构时已没有读者：先让淘汰策略放掉全部引用，再释放仍未退休的条目，已退休的由 _domain 释放
+         */
+        ~ConcurrentCache() override
+        {
+            _domain.setReclaimHook(nullptr);
+            _policy.reset();
+            for(Entry* entry : _released) delete entry;
+        }
+
+        void put(const Key& key, const Value& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), value);
+        }
+
+        void put(const Key& key, Value&& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), std::move(value));
+        }
+
+        /**
+         * @brief 读取数据：无锁查找 + 记录访问
+         */
+        bool get(const Key& key, Value& value) override
+        {
+            return visit(key, [&value](const Value& stored) { value = stored; });
+        }
+
+        Value get(const Key& key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            return visit(key, [&value](const Value& stored) { value = stored; });
+        }
+
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：命中时以 const 引用调用 fn(value)
+         * 不持有任何锁，fn 可以与写操作并发执行：fn 看到的是查找时刻的值，
+         * 即使条目随后被更新或淘汰，它也会保留到 fn 返回之后才释放。fn 中不应长时间停留，否则会推迟回收。
+         * @return 是否命中
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            return visitWithHash(key, _nodeMap.hashOf(key), std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 带预先算好哈希的读写，供分片路由复用同一个哈希值
+         * hash 必须等于 cacheHashOf<Key>(key)，否则查找结果未定义
+         */
+        template<class K>
+        bool getWithHash(const K& key, uint64_t hash, Value& value)
+        {
+            return visitWithHash(key, hash, [&value](const Value& stored) { value = stored; });
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, const Value& value)
+        {
+            putImpl(key, hash, value);
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, Value&& value)
+        {
+            putImpl(key, hash, std::move(value));
+        }
+
+        template<class K, class Fn>
+        bool visitWithHash(const K& key, uint64_t hash, Fn&& fn)
+        {
+            bool shouldDrain = false;
+            {
+                EpochGuard guard(_domain);
+                Entry* entry = _nodeMap.find(key, hash);
+                if(!entry) return false;
+                fn(entry->_value);
+                // 本轮已经记录过的条目不再写缓冲；须在读临界区内记录，见 drainConcurrent 的保证
+                uint32_t tick = _tick.load(std::memory_order_relaxed);
+                if(entry->_stamp.load(std::memory_order_relaxed) != tick)
+                {
+                    entry->_stamp.store(tick, std::memory_order_relaxed);
+                    shouldDrain = _readBuffer.record(entry);
+                }
+            }
+            if(shouldDrain) tryDrainReadBuffer();
+            return true;
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不记录访问）
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            return containsWithHash(key, _nodeMap.hashOf(key));
+        }
+
+        template<class K>
+        bool containsWithHash(const K& key, uint64_t hash)
+        {
+            EpochGuard guard(_domain);
+            return _nodeMap.find(key, hash) != nullptr;
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        template<class K>
+        void remove(const K& key)
+        {
+            removeWithHash(key, _nodeMap.hashOf(key));
+        }
+
+        template<class K>
+        void removeWithHash(const K& key, uint64_t hash)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _policy->removeLocked(key, hash);
+            retireReleased();
+        }
+
+        /**
+         * @brief 当前已占用的权重总和（淘汰策略需提供 usedWeight，如 LRUCache）
+         */
+        size_t usedWeight()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _policy->usedWeight();
+        }
+
+    private:
+        /**
+         * @brief 写入逻辑：权重与新条目在写锁外算好、构造好，锁内先发布到索引，再把引用交给淘汰策略
+         * 淘汰策略拒绝写入（如单个条目超过预算）时会立即丢掉引用，条目随即从索引摘下
+         */
+        template<class V>
+        void putImpl(const Key& key, uint64_t hash, V&& value)
+        {
+            size_t weight = _weigher(key, value);
+            Entry* entry = new Entry(key, std::forward<V>(value));
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            // 先回放积攒的访问，淘汰才能看到最新的顺序：同一轮内重复命中不再记录，热点条目少时条带可能迟迟填不满
+            if(_readBuffer.pending()) drainReadBuffer();
+            Entry* old = _nodeMap.find(key, hash);
+            if(old)
+            {
+                // 读者要么看到旧值要么看到新值；旧条目在淘汰策略放掉它的引用时退休
+                _nodeMap.replace(old, entry);
+                old->_linked = false;
+            }
+            else
+            {
+                _nodeMap.insert(entry, hash);
+            }
+            entry->_linked = true;
+            _policy->putLocked(key, EntryRef(entry, this), weight, hash);
+            retireReleased();
+        }
+
+    private:
+        EpochDomain _domain;              // 读者登记与延迟回收，须先于 _nodeMap 构造、晚于其析构
+        NodeMap _nodeMap;                 // 读无锁的并发索引：Key -> 条目
+        Weigher _weigher;                 // 权重函数，写入时在锁外计算
+        ReadBuffer<Entry> _readBuffer;    // 读者记录的访问，回放给淘汰策略
+        std::vector<Entry*> _released;    // 淘汰策略已放掉、尚未退休的条目
+        std::unique_ptr<PolicyCache> _policy; // 淘汰策略：只保存条目引用，决定淘汰顺序（只由写者访问）
+        alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> _tick; // 回放轮次：只在回放时推进，读者只读，单独占一行
+        alignas(CACHE_LINE_SIZE) std::mutex _mutex; // 写锁：put / remove / 回放串行执行
+    };
+}
+
+#endif
@@ -0,0 +1,233 @@
+// ConcurrentIndex.hpp
+
+#ifndef __CONCURRENT_INDEX_HPP__
+#define __CONCURRENT_INDEX_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "CacheHash.hpp"
+#include "EpochReclaimer.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 挂入 ConcurrentIndex 的条目需要携带的链接字段（侵入式）
+     * next 有两份，分别属于相邻两代桶数组：扩容时新一代通过另一组链接串起全部条目，
+     * 仍在旧桶数组上遍历的读者沿原来的链接继续走，不受影响。
+     */
+    template<class Entry>
+    struct ConcurrentIndexHook
+    {
+        std::atomic<Entry*> next[2];
+        uint64_t hash;
+
+        ConcurrentIndexHook() : hash(0)
+        {
+            next[0].store(nullptr, std::memory_order_relaxed);
+            next[1].store(nullptr, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief 读无锁、写串行的拉链哈希索引
+     * - 读者在 EpochGuard 保护下调用 find，全程只有 acquire 读，不取任何锁；
+     * - 写者（insert / replace / erase）由使用方的写锁串行化，修改链接时以 release 发布，
+     *   读者要么看到修改前的链，要么看到修改后的链，不会看到半成品；
+     * - 被摘下的条目由使用方通过同一个 EpochDomain 退休，索引本身只负责退休旧的桶数组。
+     * 条目数超过桶数时扩容一倍：用另一组 next 链接把所有条目挂到新桶数组上后整体发布。
+     * 上一次扩容留下的旧桶数组尚未回收时（仍可能有读者在用那组链接）暂缓扩容，链稍长但依然正确。
+     * @tparam Entry 条目类型，需继承 ConcurrentIndexHook<Entry>
+     * @tparam KeyOf 从条目取出 Key 的函数对象
+     */
+    template<class Key, class Entry, class KeyOf,
+             class Hash = CacheHash<Key>, class KeyEqual = CacheKeyEqual<Key>>
+    class ConcurrentIndex
+    {
+    private:
+        struct Table
+        {
+            size_t mask;                                   // 桶数 - 1
+            int gen;                                       // 本代使用的 next 链接下标（0 或 1）
+            std::unique_ptr<std::atomic<Entry*>[]> buckets;
+
+            Table(size_t bucketCount, int generation)
+                : mask(bucketCount - 1),
+                  gen(generation),
+                  buckets(new std::atomic<Entry*>[bucketCount])
+            {
+                for(size_t i = 0; i < bucketCount; ++i) buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+        };
+
+        /**
+         * @brief 找到条目在当前桶数组中的前驱链接（写者调用）
+         */
+        std::atomic<Entry*>* linkTo(Table* table, Entry* entry)
+        {
+            std::atomic<Entry*>* link = &table->buckets[entry->hash & table->mask];
+            while(true)
+            {
+                Entry* cur = link->load(std::memory_order_relaxed);
+                if(cur == entry) return link;
+                link = &cur->next[table->gen];
+            }
+        }
+
+        /**
+         * @brief 扩容：用另一代链接把全部条目挂到两倍大小的新桶数组上，再原子地切换
+         */
+        void grow(Table* old)
+        {
+            if(_oldTablePending && !_domain.isSafe(_oldTableEpoch))
+            {
+                _domain.collect(); // 读者通常很快离开，推进一次纪元后再确认
+                if(!_domain.isSafe(_oldTableEpoch)) return; // 另一组链接仍可能有读者在用
+            }
+            Table* table = new Table((old->mask + 1) * 2, 1 - old->gen);
+            for(size_t i = 0; i <= old->mask; ++i)
+            {
+                for(Entry* e = old->buckets[i].load(std::memory_order_relaxed); e;
+                    e = e->next[old->gen].load(std::memory_order_relaxed))
+                {
+                    std::atomic<Entry*>& bucket = table->buckets[e->hash & table->mask];
+                    e->next[table->gen].store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    bucket.store(e, std::memory_order_relaxed);
+                }
+            }
+            _table.store(table, std::memory_order_release); // 新桶数组及其链接随指针一起发布
+            _oldTableEpoch = _domain.currentEpoch();
+            _oldTablePending = true;
+            _domain.retire(old);
+        }
+
+        static size_t bucketCountFor(size_t count)
+        {
+            size_t buckets = 16;
+            while(buckets < count) buckets <<= 1;
+            return buckets;
+        }
+
+    public:
+        /**
+         * @param domain 读者与写者共用的回收域
+         * @param expected 预计的条目数，用于确定初始桶数
+         */
+        explicit ConcurrentIndex(EpochDomain& domain, size_t expected = 0,
+                                 KeyOf keyOf = KeyOf(), Hash hash = Hash(), KeyEqual equal = KeyEqual())
+            : _domain(domain),
+              _table(new Table(bucketCountFor(expected), 0)),
+              _size(0),
+              _oldTableEpoch(0),
+              _oldTablePending(false),
+              _keyOf(keyOf),
+              _hash(hash),
+              _equal(equal)
+        {}
+
+        ConcurrentIndex(const ConcurrentIndex&) = delete;
+        ConcurrentIndex& operator=(const ConcurrentIndex&) = delete;
+
+        /**
+         * @brief 析构时不再有读者；条目由使用方释放，这里只释放当前桶数组
+         */
+        ~ConcurrentIndex()
+        {
+            delete _table.load(std::memory_order_relaxed);
+        }
+
+        template<class K>
+        uint64_t hashOf(const K& key) const
+        {
+            return mixHash(static_cast<uint64_t>(_hash(key)));
+        }
+
+        /**
+         * @brief 无锁查找（调用方持有 EpochGuard，也可以由持有写锁的写者调用）
+         * @return 命中的条目，未命中返回空指针；条目在 EpochGuard 析构前不会被释放
+         */
+        template<class K>
+        Entry* find(const K& key) const
+        {
+            return find(key, hashOf(key));
+        }
+
+        /**
+         * @brief 带预先算好哈希的查找，h 必须等于 hashOf(key)（分片路由复用同一个哈希值）
+         */
+        template<class K>
+        Entry* find(const K& key, uint64_t h) const
+        {
+            Table* table = _table.load(std::memory_order_acquire);
+            for(Entry* e = table->buckets[h & table->mask].load(std::memory_order_acquire); e;
+                e = e->next[table->gen].load(std::memory_order_acquire))
+            {
+                if(e->hash == h && _equal(_keyOf(*e), key)) return e;
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief 插入条目（写者调用，调用方保证 Key 尚不存在）
+         * 条目的字段在发布之前全部写好，读者看到指针时一定看到完整的条目
+         */
+        void insert(Entry* entry)
+        {
+            insert(entry, hashOf(_keyOf(*entry)));
+        }
+
+        /**
+         * @brief 带预先算好哈希的插入，h 必须等于 hashOf(条目的 Key)
+         */
+        void insert(Entry* entry, uint64_t h)
+        {
+            Table* table = _table.load(std::memory_order_relaxed);
+            entry->hash = h;
+            std::atomic<Entry*>& bucket = table->buckets[entry->hash & table->mask];
+            entry->next[table->gen].store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            bucket.store(entry, std::memory_order_release);
+            if(++_size > table->mask + 1) grow(table);
+        }
+
+        /**
+         * @brief 用新条目替换链上的旧条目（写者调用，二者 Key 相同）
+         * 读者要么看到旧条目，要么看到新条目；旧条目由调用方退休
+         */
+        void replace(Entry* oldEntry, Entry* newEntry)
+        {
+            Table* table = _table.load(std::memory_order_relaxed);
+            newEntry->hash = oldEntry->hash;
+            newEntry->next[table->gen].store(oldEntry->next[table->gen].load(std::memory_order_relaxed),
+                                             std::memory_order_relaxed);
+            linkTo(table, oldEntry)->store(newEntry, std::memory_order_release);
+        }
+
+        /**
+         * @brief 把条目从链上摘下（写者调用），条目由调用方退休
+         * 被摘下条目自身的 next 保持不变，正停在它上面的读者仍能继续往后遍历
+         */
+        void erase(Entry* entry)
+        {
+            Table* table = _table.load(std::memory_order_relaxed);
+            linkTo(table, entry)->store(entry->next[table->gen].load(std::memory_order_relaxed),
+                                        std::memory_order_release);
+            --_size;
+        }
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+    private:
+        EpochDomain& _domain;
+        std::atomic<Table*> _table;   // 当前桶数组，读者以 acquire 读取
+        size_t _size;                 // 条目数（只由写者访问）
+        uint64_t _oldTableEpoch;      // 上一次扩容退休旧桶数组时的纪元
+        bool _oldTablePending;        // 是否发生过扩容（首次扩容无需等待）
+        KeyOf _keyOf;
+        Hash _hash;
+        KeyEqual _equal;
+    };
+}
+
+#endif
@@ -0,0 +1,202 @@
+// EpochReclaimer.hpp
+
+#ifndef __EPOCH_RECLAIMER_HPP__
+#define __EPOCH_RECLAIMER_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace myCache
+{
+    /**
+     * @brief 基于纪元（epoch）的延迟回收域
+     * 无锁读者在访问共享结构前进入当前纪元，离开时退出；写者把摘下的对象“退休”并记下当时的纪元。
+     * 只有当所有仍在读的线程都已进入更新的纪元之后，全局纪元才能前进；
+     * 对象退休两个纪元之后，不可能再有读者持有它的指针，此时才真正释放。
+     * 约束：
+     * - 读者通过 EpochGuard 进入/退出，可以任意多个线程同时读，同一线程可以嵌套；
+     * - retire / collect 不是线程安全的，由使用方的写锁串行化（一个回收域对应一把写锁）。
+     */
+    class EpochDomain
+    {
+    public:
+        static constexpr size_t MAX_READERS = 128; // 同时处于读临界区的线程数上限，超出时等待空位
+
+    private:
+        // 读者槽位：0 表示空闲，否则为该读者进入时的纪元；每个槽位独占一条缓存行
+        struct alignas(64) ReaderSlot
+        {
+            std::atomic<uint64_t> epoch;
+
+            ReaderSlot() : epoch(0) {}
+        };
+
+        struct Retired
+        {
+            void* ptr;
+            void (*deleter)(void*);
+            uint64_t epoch;
+        };
+
+        /**
+         * @brief 每个线程固定的起始槽位，不同线程大概率落在不同槽位上
+         */
+        static size_t slotHint()
+        {
+            static std::atomic<size_t> nextHint(0);
+            static thread_local size_t hint = nextHint.fetch_add(1, std::memory_order_relaxed);
+            return hint % MAX_READERS;
+        }
+
+    public:
+        EpochDomain() : _epoch(1), _retireThreshold(64) {}
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+
+        /**
+         * @brief 析构时已没有读者，直接释放所有退休对象
+         */
+        ~EpochDomain()
+        {
+            for(Retired& item : _retired) item.deleter(item.ptr);
+        }
+
+        /**
+         * @brief 进入读临界区，返回占用的槽位下标
+         * 先抢占一个空槽位写入纪元，再确认全局纪元在写入前后没有变化，
+         * 否则写者可能已经依据旧的槽位状态推进了纪元，需要以新纪元重新登记。
+         */
+        size_t enter()
+        {
+            uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+            size_t slot = slotHint();
+            for(size_t probes = 0; ; ++probes)
+            {
+                uint64_t expected = 0;
+                if(_readers[slot].epoch.compare_exchange_strong(expected, epoch, std::memory_order_seq_cst))
+                    break;
+                slot = (slot + 1) % MAX_READERS;
+                if(probes >= MAX_READERS)
+                {
+                    std::this_thread::yield(); // 所有槽位都被占用：让出时间片等待读者离开
+                    probes = 0;
+                }
+            }
+            while(true)
+            {
+                uint64_t now = _epoch.load(std::memory_order_seq_cst);
+                if(now == epoch) break;
+                epoch = now;
+                _readers[slot].epoch.store(epoch, std::memory_order_seq_cst);
+            }
+            return slot;
+        }
+
+        /**
+         * @brief 离开读临界区
+         */
+        void exit(size_t slot)
+        {
+            _readers[slot].epoch.store(0, std::memory_order_release);
+        }
+
+        /**
+         * @brief 退休一个对象：调用方已把它从共享结构中摘下，待没有读者能看到它时由 deleter 释放
+         */
+        void retire(void* ptr, void (*deleter)(void*))
+        {
+            _retired.push_back(Retired{ptr, deleter, _epoch.load(std::memory_order_relaxed)});
+            if(_retired.size() >= _retireThreshold) collect();
+        }
+
+        template<class T>
+        void retire(T* ptr)
+        {
+            retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+        }
+
+        /**
+         * @brief 设置回收前的回调：collect 推进纪元之后、释放对象之前调用（仍在写者的写锁内）
+         * 读者若在读临界区内把对象指针登记到别处（如读缓冲），须在回调中取走这些登记，之后对象才会被释放：
+         * 能看到待释放对象的读者都已离开，它们的登记在回调开始前已经完成。回调中不能再调用 retire / collect。
+         */
+        void setReclaimHook(std::function<void()> hook)
+        {
+            _reclaimHook = std::move(hook);
+        }
+
+        /**
+         * @brief 尝试推进纪元并释放所有已安全的退休对象
+         * 释放不完时把下一次触发的阈值放宽一倍，避免读者长时间停留时每次 retire 都扫描所有槽位
+         */
+        void collect()
+        {
+            if(tryAdvance()) tryAdvance(); // 没有读者时可以连推两个纪元，刚退休的对象也能立即释放
+            uint64_t safe = _epoch.load(std::memory_order_seq_cst);
+            if(_reclaimHook) _reclaimHook();
+            size_t kept = 0;
+            for(Retired& item : _retired)
+            {
+                if(item.epoch + 2 <= safe) item.deleter(item.ptr);
+                else _retired[kept++] = item;
+            }
+            _retired.resize(kept);
+            _retireThreshold = kept >= 32 ? kept * 2 : 64;
+        }
+
+        /**
+         * @brief 在退休纪元 epoch 之后是否已经过了足够的纪元，使当时的读者全部离开
+         */
+        bool isSafe(uint64_t epoch) const
+        {
+            return epoch + 2 <= _epoch.load(std::memory_order_seq_cst);
+        }
+
+        uint64_t currentEpoch() const { return _epoch.load(std::memory_order_seq_cst); }
+
+    private:
+        /**
+         * @brief 所有活跃读者都已登记在当前纪元时，纪元 +1
+         */
+        bool tryAdvance()
+        {
+            uint64_t epoch = _epoch.load(std::memory_order_seq_cst);
+            for(const ReaderSlot& reader : _readers)
+            {
+                uint64_t seen = reader.epoch.load(std::memory_order_seq_cst);
+                if(seen != 0 && seen != epoch) return false;
+            }
+            return _epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+        }
+
+    private:
+        std::atomic<uint64_t> _epoch;          // 全局纪元，从 1 开始（槽位中的 0 表示空闲）
+        ReaderSlot _readers[MAX_READERS];      // 读者登记表
+        std::vector<Retired> _retired;         // 待回收对象（只由写者访问）
+        size_t _retireThreshold;               // 积累到多少个待回收对象时尝试回收
+        std::function<void()> _reclaimHook;    // 回收前的回调，可为空
+    };
+
+    /**
+     * @brief 读临界区的 RAII 守卫：构造时进入，析构时离开
+     */
+    class EpochGuard
+    {
+    public:
+        explicit EpochGuard(EpochDomain& domain) : _domain(domain), _slot(domain.enter()) {}
+        ~EpochGuard() { _domain.exit(_slot); }
+
+        EpochGuard(const EpochGuard&) = delete;
+        EpochGuard& operator=(const EpochGuard&) = delete;
+
+    private:
+        EpochDomain& _domain;
+        size_t _slot;
+    };
+}
+
+#endif
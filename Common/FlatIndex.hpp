@@ -0,0 +1,224 @@
+// FlatIndex.hpp
+
+#ifndef __FLAT_INDEX_HPP__
+#define __FLAT_INDEX_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "CacheHash.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 缓存专用的开放寻址哈希索引
+     * 与 std::unordered_map 的区别：
+     * - 槽位连续存放在一个数组中，每个槽位只有 {哈希值, 映射值}，查找时沿数组线性探测，
+     *   不再经过“桶指针 -> 链表节点 -> 缓存节点”的多次跳转；
+     * - 不单独保存 Key：Key 由 KeyOf 从映射值（通常是缓存节点）中取出，缓存节点里本来就存着 Key，
+     *   省掉一份 Key 的拷贝与内存；
+     * - 删除采用后移（backward shift）而不是墓碑：淘汰每时每刻都在发生，墓碑会让探测链越来越长，
+     *   后移删除保证表中永远只有“有效槽位”和“空槽位”两种状态；
+     * - 先比较完整哈希值再比较 Key，绝大多数不相等的槽位不会触碰 Key 本身。
+     * 负载因子上限 3/4，容量始终为 2 的幂。插入、扩容、删除都会移动槽位，因此 find 返回的指针
+     * 只在下一次修改之前有效。
+     * @tparam KeyOf 从映射值取出 Key 的函数对象，可以带状态（如指向节点池）
+     */
+    template<class Key, class Mapped, class KeyOf,
+             class Hash = CacheHash<Key>, class KeyEqual = CacheKeyEqual<Key>>
+    class FlatIndex
+    {
+    public:
+        /**
+         * @brief 槽位：hash 为 0 表示空槽位（真实哈希值为 0 时记为 1）
+         */
+        struct Slot
+        {
+            size_t hash;
+            Mapped mapped;
+
+            Slot() : hash(0), mapped() {}
+        };
+        typedef Slot* iterator;
+
+    private:
+        /**
+         * @brief 槽位中保存的哈希值：0 留给空槽位，真实哈希值为 0 时记为 1
+         */
+        static size_t slotHash(uint64_t h)
+        {
+            size_t s = static_cast<size_t>(h);
+            return s ? s : 1;
+        }
+
+        /**
+         * @brief 按哈希值找到第一个空槽位并放入（调用方保证 Key 不存在且容量足够）
+         */
+        void place(size_t h, Mapped&& mapped)
+        {
+            size_t i = h & _mask;
+            while(_slots[i].hash != 0)
+            {
+                i = (i + 1) & _mask;
+            }
+            _slots[i].hash = h;
+            _slots[i].mapped = std::move(mapped);
+        }
+
+        /**
+         * @brief 扩容到 newCapacity（2 的幂）并重新放置所有槽位，哈希值已存在槽位中，无需重新计算
+         */
+        void rehash(size_t newCapacity)
+        {
+            std::vector<Slot> old;
+            old.swap(_slots);
+            _slots.resize(newCapacity);
+            _mask = newCapacity - 1;
+            for(Slot& slot : old)
+            {
+                if(slot.hash != 0) place(slot.hash, std::move(slot.mapped));
+            }
+        }
+
+        static size_t capacityFor(size_t count)
+        {
+            size_t capacity = 8;
+            while(capacity * 3 / 4 < count) capacity <<= 1;
+            return capacity;
+        }
+
+    public:
+        explicit FlatIndex(KeyOf keyOf = KeyOf(), Hash hash = Hash(), KeyEqual equal = KeyEqual())
+            : _size(0),
+              _mask(0),
+              _keyOf(keyOf),
+              _hash(hash),
+              _equal(equal)
+        {}
+
+        /**
+         * @brief 混淆后的哈希值；使用默认 Hash 时与 cacheHashOf<Key> 相同，分片路由算出的值可以直接复用
+         */
+        template<class K>
+        uint64_t hashOf(const K& key) const
+        {
+            return mixHash(static_cast<uint64_t>(_hash(key)));
+        }
+
+        /**
+         * @brief 查找 Key（或其异构查找类型）
+         * @return 命中返回槽位指针，未命中返回 end()（空指针）
+         */
+        template<class K>
+        iterator find(const K& key)
+        {
+            return find(key, hashOf(key));
+        }
+
+        /**
+         * @brief 带预先算好哈希的查找，hash 必须等于 hashOf(key)
+         */
+        template<class K>
+        iterator find(const K& key, uint64_t hash)
+        {
+            if(_size == 0) return end();
+            size_t h = slotHash(hash);
+            size_t i = h & _mask;
+            while(_slots[i].hash != 0)
+            {
+                if(_slots[i].hash == h && _equal(_keyOf(_slots[i].mapped), key))
+                    return &_slots[i];
+                i = (i + 1) & _mask;
+            }
+            return end();
+        }
+
+        iterator end() const { return nullptr; }
+
+        /**
+         * @brief 插入一个映射值，其 Key 由 KeyOf 取出；调用方保证该 Key 尚不存在
+         */
+        void insert(Mapped mapped)
+        {
+            uint64_t hash = hashOf(_keyOf(mapped));
+            insert(std::move(mapped), hash);
+        }
+
+        /**
+         * @brief 插入一个映射值，hash 必须等于 hashOf(其 Key)
+         */
+        void insert(Mapped mapped, uint64_t hash)
+        {
+            if(_slots.empty() || (_size + 1) > _slots.size() * 3 / 4)
+            {
+                rehash(_slots.empty() ? 8 : _slots.size() * 2);
+            }
+            place(slotHash(hash), std::move(mapped));
+            _size++;
+        }
+
+        /**
+         * @brief 删除槽位：把后续探测链上可以前移的槽位依次前移，填补空洞（不留墓碑）
+         */
+        void erase(iterator it)
+        {
+            size_t i = static_cast<size_t>(it - _slots.data());
+            size_t j = i;
+            while(true)
+            {
+                j = (j + 1) & _mask;
+                if(_slots[j].hash == 0) break;
+                size_t home = _slots[j].hash & _mask;
+                // 空洞 i 位于 j 的理想位置 home 与 j 之间（循环意义下）时，j 可以前移到 i
+                if(((j - home) & _mask) >= ((j - i) & _mask))
+                {
+                    _slots[i].hash = _slots[j].hash;
+                    _slots[i].mapped = std::move(_slots[j].mapped);
+                    i = j;
+                }
+            }
+            _slots[i].hash = 0;
+            _slots[i].mapped = Mapped(); // 及时释放映射值持有的资源（如节点的引用计数）
+            _size--;
+        }
+
+        template<class K>
+        bool erase(const K& key)
+        {
+            iterator it = find(key);
+            if(it == end()) return false;
+            erase(it);
+            return true;
+        }
+
+        /**
+         * @brief 预留至少能容纳 count 个条目而不扩容的空间
+         */
+        void reserve(size_t count)
+        {
+            size_t capacity = capacityFor(count);
+            if(capacity > _slots.size()) rehash(capacity);
+        }
+
+        void clear()
+        {
+            _slots.clear();
+            _size = 0;
+            _mask = 0;
+        }
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+    private:
+        std::vector<Slot> _slots; // 连续槽位数组，容量为 2 的幂（未插入过任何条目时为空）
+        size_t _size;             // 有效条目数
+        size_t _mask;             // 容量 - 1，用于把哈希值映射到槽位下标
+        KeyOf _keyOf;             // 从映射值取出 Key
+        Hash _hash;
+        KeyEqual _equal;
+    };
+}
+
+#endif
@@ -0,0 +1,127 @@
+// FrequencySketch.hpp
+
+#ifndef __FREQUENCY_SKETCH_HPP__
+#define __FREQUENCY_SKETCH_HPP__
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace myCache
+{
+    /**
+     * @brief 4 位计数器的 Count-Min Sketch，用于估算 Key 最近的访问频次（TinyLFU 的频次过滤器）
+     * 每个 64 位字装 16 个 4 位计数器，共 4 行：Key 的哈希先选出 4 个字（每行一个），
+     * 再由哈希的低 2 位决定在各字中使用哪一组计数器（4 行分别取组内第 0～3 个）。
+     * 计数器饱和于 15；频次估算取 4 个计数器中的最小值。
+     * 累计增加次数达到采样窗口（10 倍预期条目数）时所有计数器减半（老化），
+     * 过去的热点逐渐被遗忘，频次反映的是最近一段访问。
+     * 每个预期条目约占 8 字节，不保存 Key 本身。不加锁，由所属缓存的锁保护。
+     */
+    class FrequencySketch
+    {
+    public:
+        static constexpr size_t MAX_TABLE_WORDS = size_t(1) << 22; // 表大小上限（32MB）
+        static constexpr unsigned MAX_FREQUENCY = 15;
+
+    private:
+        static constexpr uint64_t RESET_MASK = 0x7777777777777777ULL; // 减半后去掉从高位移入的位
+        static constexpr uint64_t ONE_MASK = 0x1111111111111111ULL;   // 每个计数器的最低位
+
+        /**
+         * @brief 第 row 行所选字的下标：每行用不同的种子再混淆一次，4 行的位置相互独立
+         */
+        size_t indexOf(uint64_t hash, int row) const
+        {
+            static constexpr uint64_t SEEDS[4] = {
+                0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL
+            };
+            uint64_t h = (hash + SEEDS[row]) * SEEDS[row];
+            h += h >> 32;
+            return static_cast<size_t>(h) & _tableMask;
+        }
+
+        /**
+         * @brief 计数器在字中的位偏移：哈希低 2 位选出一组 4 个计数器，第 row 行用组内第 row 个
+         */
+        static unsigned shiftOf(uint64_t hash, int row)
+        {
+            return ((static_cast<unsigned>(hash & 3) << 2) + row) << 2;
+        }
+
+    public:
+        /**
+         * @param expectedEntries 预期同时存在的条目数，决定表大小与采样窗口
+         */
+        explicit FrequencySketch(size_t expectedEntries)
+            : _additions(0)
+        {
+            size_t words = 1;
+            size_t target = std::max<size_t>(expectedEntries, 1);
+            while(words < target && words < MAX_TABLE_WORDS) words <<= 1;
+            _table.assign(words, 0);
+            _tableMask = words - 1;
+            _sampleSize = 10 * std::max<size_t>(target, 1);
+        }
+
+        /**
+         * @brief 记录一次访问：4 行中未饱和的计数器各 +1，有计数器增加时计入采样窗口
+         * @param hash Key 的混淆哈希（cacheHashOf 或索引的 hashOf）
+         */
+        void increment(uint64_t hash)
+        {
+            bool added = false;
+            for(int row = 0; row < 4; ++row)
+            {
+                uint64_t& word = _table[indexOf(hash, row)];
+                unsigned shift = shiftOf(hash, row);
+                if(((word >> shift) & 0xf) != MAX_FREQUENCY)
+                {
+                    word += uint64_t(1) << shift;
+                    added = true;
+                }
+            }
+            if(added && ++_additions >= _sampleSize) reset();
+        }
+
+        /**
+         * @brief 估算的访问频次（0～15）
+         */
+        unsigned frequency(uint64_t hash) const
+        {
+            unsigned freq = MAX_FREQUENCY;
+            for(int row = 0; row < 4; ++row)
+            {
+                unsigned count = static_cast<unsigned>((_table[indexOf(hash, row)] >> shiftOf(hash, row)) & 0xf);
+                freq = std::min(freq, count);
+            }
+            return freq;
+        }
+
+    private:
+        /**
+         * @brief 老化：所有计数器减半；奇数计数器被截掉的 0.5 按每 4 个（一个 Key 占 4 行）折算回采样计数
+         */
+        void reset()
+        {
+            size_t odd = 0;
+            for(uint64_t& word : _table)
+            {
+                odd += std::bitset<64>(word & ONE_MASK).count();
+                word = (word >> 1) & RESET_MASK;
+            }
+            size_t truncated = odd / 4;
+            _additions = (_additions > truncated ? _additions - truncated : 0) / 2;
+        }
+
+    private:
+        std::vector<uint64_t> _table; // 计数器表，每个字 16 个 4 位计数器
+        size_t _tableMask;            // 表大小为 2 的幂，下标取低位
+        size_t _sampleSize;           // 采样窗口：累计增加这么多次后老化一次
+        size_t _additions;            // 本窗口内已累计的增加次数
+    };
+}
+
+#endif
@@ -0,0 +1,130 @@
+// HashConcurrentCache.hpp
+
+#ifndef __HASH_CONCURRENT_CACHE_HPP__
+#define __HASH_CONCURRENT_CACHE_HPP__
+
+#include <cstdint>
+#include <utility>
+#include "ConcurrentCache.hpp"
+#include "ShardArray.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief HashConcurrentCache 模板类
+     * 与 HashLRUCache 相同的分片方式，每个分片是一个 ConcurrentCache。
+     * 分片内部的读操作不取任何锁，分片用来拆分写锁与读缓冲的回放：每个分片各有一把写锁，
+     * 写操作和回放只在所在分片内串行，读多写少时整体吞吐量随核心数增长。
+     * Weigher 会传递给每个分片，容量（权重预算）按分片均分。
+     */
+    template<class Key, class Value, template<class, class, class> class Policy, class Weigher = UnitWeigher<Key, Value>>
+    class HashConcurrentCache
+    {
+    private:
+        /**
+         * @brief 哈希定位函数：与分片内部索引相同的混淆哈希（cacheHashOf），取最高几位选择分片，
+         * 同一个哈希值随后交给分片内部的索引，每次操作只计算一次
+         */
+        template<class K>
+        uint64_t Hash(const K& key)
+        {
+            return cacheHashOf<Key>(key);
+        }
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 总缓存容量（所有条目权重之和的上限）
+         * @param sliceNum 分片数量，不大于 0 时取硬件并发核心数，向上取整为 2 的幂
+         * @param weigher 权重函数，默认每个条目计 1
+         * @param policyArgs 淘汰策略的其余构造参数，原样传给每个分片
+         */
+        template<class... PolicyArgs>
+        HashConcurrentCache(size_t capacity, int sliceNum, Weigher weigher = Weigher(), PolicyArgs... policyArgs)
+            : _capacity(capacity),
+              _router(sliceNum),
+              _sliceCaches(_router.shardCount(), _router.perShard(capacity), weigher, policyArgs...)
+        {}
+
+        void put(const Key& key, const Value& value)
+        {
+            uint64_t hash = Hash(key);
+            _sliceCaches[_router.shardOf(hash)].putWithHash(key, hash, value);
+        }
+
+        void put(const Key& key, Value&& value)
+        {
+            uint64_t hash = Hash(key);
+            _sliceCaches[_router.shardOf(hash)].putWithHash(key, hash, std::move(value));
+        }
+
+        bool get(const Key& key, Value& value)
+        {
+            uint64_t hash = Hash(key);
+            return _sliceCaches[_router.shardOf(hash)].getWithHash(key, hash, value);
+        }
+
+        Value get(const Key& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            uint64_t hash = Hash(key);
+            return _sliceCaches[_router.shardOf(hash)].getWithHash(key, hash, value);
+        }
+
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：不取锁，命中时以 const 引用调用 fn(value)（fn 可能与写操作并发，见 ConcurrentCache::visit）
+         * @return 是否命中
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            uint64_t hash = Hash(key);
+            return _sliceCaches[_router.shardOf(hash)].visitWithHash(key, hash, std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不记录访问）
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            uint64_t hash = Hash(key);
+            return _sliceCaches[_router.shardOf(hash)].containsWithHash(key, hash);
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        template<class K>
+        void remove(const K& key)
+        {
+            uint64_t hash = Hash(key);
+            _sliceCaches[_router.shardOf(hash)].removeWithHash(key, hash);
+        }
+
+    private:
+        size_t _capacity; // 总容量
+        ShardRouter _router; // 分片路由：分片数为 2 的幂
+        ShardArray<ConcurrentCache<Key, Value, Policy, Weigher>> _sliceCaches;
+    };
+}
+
+#endif
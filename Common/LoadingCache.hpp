@@ -0,0 +1,210 @@
+// LoadingCache.hpp
+
+#ifndef __LOADING_CACHE_HPP__
+#define __LOADING_CACHE_HPP__
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include "CacheHash.hpp"
+#include "CachePolicy.hpp"
+#include "ShardArray.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 带回源合并（single-flight）的加载式缓存
+     * 热点 Key 失效时，同一时刻的所有调用方都会未命中并各自去后端加载，回源压力远大于缓存省下的开销（缓存击穿）。
+     * getOrLoad 在未命中时先登记一次“正在加载”：同一 Key 的并发未命中只有第一个调用方（领头者）执行 loader，
+     * 其余调用方等待同一个结果；领头者写入缓存后才撤销登记，之后到达的调用方直接命中缓存。
+     * loader 抛出异常时，异常原样传给本轮所有等待者，不写入缓存，下一次调用重新加载。
+     *
+     * 本类不持有缓存，只包装一个已有的缓存对象：可以是任意 CachePolicy（LRUCache、ArcCache 等），
+     * 也可以是分片版本（HashLRUCache、HashArcCache 等，以具体类型作为 Cache 参数）。
+     * “正在加载”登记表按与分片缓存相同的路由拆成若干段，各段独立加锁，只在未命中时访问。
+     * 线程安全：与被包装的缓存相同；缓存对象的生命周期须长于本对象。
+     * @tparam Cache 被包装的缓存类型，需提供 get(key, value) 与 put(key, value)
+     */
+    template<class Key, class Value, class Cache = CachePolicy<Key, Value>>
+    class LoadingCache
+    {
+    private:
+        /**
+         * @brief 一次正在进行的加载：领头者持有 promise，等待者共享 future
+         */
+        struct Flight
+        {
+            std::promise<Value> promise;
+            std::shared_future<Value> future;
+
+            Flight() : future(promise.get_future().share()) {}
+        };
+        typedef std::shared_ptr<Flight> FlightPtr;
+
+        /**
+         * @brief 登记表的一段：一把锁保护一张 Key -> Flight 的表
+         */
+        struct FlightShard
+        {
+            std::mutex mutex;
+            std::unordered_map<Key, FlightPtr, CacheHash<Key>, CacheKeyEqual<Key>> flights;
+        };
+
+    public:
+        /**
+         * @param cache 被包装的缓存
+         * @param sliceNum 登记表的段数，不大于 0 时取硬件并发核心数，向上取整为 2 的幂
+         */
+        explicit LoadingCache(Cache& cache, int sliceNum = 0)
+            : _cache(cache),
+              _router(sliceNum),
+              _flightShards(_router.shardCount())
+        {}
+
+        LoadingCache(const LoadingCache&) = delete;
+        LoadingCache& operator=(const LoadingCache&) = delete;
+
+        /**
+         * @brief 读取数据，未命中时调用 loader 加载并写入缓存
+         * 同一 Key 的并发未命中只调用一次 loader，其余调用方阻塞等待它的结果。
+         * @param loader 形如 Value(const Key&) 的可调用对象
+         * @return 缓存中的值或加载得到的值；loader 抛出的异常会传给本轮所有调用方
+         */
+        template<class Loader>
+        Value getOrLoad(const Key& key, Loader&& loader)
+        {
+            Value value{};
+            if(_cache.get(key, value)) return value;
+
+            bool leader = false;
+            FlightPtr flight = join(key, leader);
+            if(!leader) return flight->future.get();
+
+            load(key, loader, flight);
+            return flight->future.get();
+        }
+
+        /**
+         * @brief getOrLoad 的异步版本
+         * 命中时返回已就绪的 future；已有加载在进行时返回那次加载的 future；
+         * 否则本调用成为领头者，在新线程中执行 loader 并写入缓存（登记在返回之前完成，随后的同步调用也会合并进来）。
+         * 领头者返回的 future 来自 std::async：最后一个引用析构时会等待加载结束，本对象须在此之后才能析构。
+         * @param loader 形如 Value(const Key&) 的可调用对象，会被拷贝到加载线程中
+         */
+        template<class Loader>
+        std::shared_future<Value> getOrLoadAsync(const Key& key, Loader loader)
+        {
+            Value value{};
+            if(_cache.get(key, value))
+            {
+                std::promise<Value> ready;
+                ready.set_value(std::move(value));
+                return ready.get_future().share();
+            }
+
+            bool leader = false;
+            FlightPtr flight = join(key, leader);
+            if(!leader) return flight->future;
+
+            try
+            {
+                return std::async(std::launch::async, [this, key, loader, flight]() mutable
+                {
+                    load(key, loader, flight);
+                    return flight->future.get();
+                }).share();
+            }
+            catch(...)
+            {
+                // 线程没能启动（std::system_error 等）：本轮已登记，须唤醒已合并进来的等待者并撤销登记，
+                // 否则它们永远阻塞，之后同一 Key 的调用也会一直合并到这次不会完成的加载上
+                flight->promise.set_exception(std::current_exception());
+                leave(key);
+                throw;
+            }
+        }
+
+        /**
+         * @brief 当前正在加载的 Key 数（只用于观察）
+         */
+        size_t inflightCount()
+        {
+            size_t count = 0;
+            for(size_t i = 0; i < _flightShards.size(); ++i)
+            {
+                std::lock_guard<std::mutex> lock(_flightShards[i].mutex);
+                count += _flightShards[i].flights.size();
+            }
+            return count;
+        }
+
+        Cache& cache() { return _cache; }
+
+    private:
+        FlightShard& shardOf(const Key& key)
+        {
+            return _flightShards[_router.shardOf(cacheHashOf<Key>(key))];
+        }
+
+        /**
+         * @brief 加入 Key 的加载：已有登记时返回它，否则新登记一次并将 leader 置为 true
+         */
+        FlightPtr join(const Key& key, bool& leader)
+        {
+            FlightShard& shard = shardOf(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            FlightPtr& flight = shard.flights[key];
+            if(!flight)
+            {
+                flight = std::make_shared<Flight>();
+                leader = true;
+            }
+            return flight;
+        }
+
+        /**
+         * @brief 领头者执行加载：写入缓存、唤醒等待者、撤销登记（顺序不能颠倒）
+         * 先写缓存再撤销登记，保证任何时刻未命中的调用方要么看到登记、要么能命中缓存，不会再次回源。
+         */
+        template<class Loader>
+        void load(const Key& key, Loader& loader, const FlightPtr& flight)
+        {
+            try
+            {
+                // 登记之前的一瞬间，上一轮领头者可能刚写入缓存并撤销登记，这里再查一次
+                Value value{};
+                if(!_cache.get(key, value))
+                {
+                    value = loader(key);
+                    _cache.put(key, value);
+                }
+                flight->promise.set_value(std::move(value));
+            }
+            catch(...)
+            {
+                flight->promise.set_exception(std::current_exception());
+            }
+            leave(key);
+        }
+
+        /**
+         * @brief 撤销 Key 的登记（promise 须已设置结果）
+         */
+        void leave(const Key& key)
+        {
+            FlightShard& shard = shardOf(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.flights.erase(key);
+        }
+
+    private:
+        Cache& _cache;                          // 被包装的缓存
+        ShardRouter _router;                    // 登记表的分段路由
+        ShardArray<FlightShard> _flightShards;  // 正在加载的 Key，按段加锁
+    };
+}
+
+#endif
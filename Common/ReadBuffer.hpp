@@ -0,0 +1,193 @@
+// ReadBuffer.hpp
+
+#ifndef __READ_BUFFER_HPP__
+#define __READ_BUFFER_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <variant>
+#include "CacheHash.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 与读缓冲配套的缓存锁
+     * 开启读缓冲时命中需要共享锁，使用 std::shared_mutex；未开启时所有操作都是独占的，
+     * 使用开销更小的 std::mutex（无竞争时读写锁的加解锁约慢一倍），此时 lock_shared 也退化为独占。
+     * 满足 Lockable 与 SharedLockable，可直接配合 std::unique_lock / std::shared_lock 使用。
+     * 两种锁放在同一个 std::variant 中，构造时选定其一，每个缓存（分片）只持有一把锁；
+     * 是否开启读缓冲是构造参数，锁的类型因此只能在运行时选择，每次加解锁多一次可预测的分支。
+     * 按缓存行对齐并独占整行：每次加解锁都会写锁字，不能让它与缓存的索引、计数器挤在同一行里。
+     */
+    class alignas(CACHE_LINE_SIZE) CacheMutex
+    {
+    public:
+        explicit CacheMutex(bool shared)
+        {
+            if(shared) _lock.emplace<std::shared_mutex>();
+        }
+        CacheMutex(const CacheMutex&) = delete;
+        CacheMutex& operator=(const CacheMutex&) = delete;
+
+        void lock() { if(std::mutex* m = plain()) m->lock(); else rw()->lock(); }
+        bool try_lock() { std::mutex* m = plain(); return m ? m->try_lock() : rw()->try_lock(); }
+        void unlock() { if(std::mutex* m = plain()) m->unlock(); else rw()->unlock(); }
+
+        void lock_shared() { if(std::mutex* m = plain()) m->lock(); else rw()->lock_shared(); }
+        bool try_lock_shared() { std::mutex* m = plain(); return m ? m->try_lock() : rw()->try_lock_shared(); }
+        void unlock_shared() { if(std::mutex* m = plain()) m->unlock(); else rw()->unlock_shared(); }
+
+    private:
+        std::mutex* plain() { return std::get_if<std::mutex>(&_lock); }
+        std::shared_mutex* rw() { return std::get_if<std::shared_mutex>(&_lock); }
+
+    private:
+        std::variant<std::mutex, std::shared_mutex> _lock; // 未开启读缓冲时为 std::mutex，开启时为 std::shared_mutex
+    };
+
+    /**
+     * @brief 分条带、可丢弃的读访问缓冲（参考 Caffeine 的 read buffer）
+     * 命中时不再在锁内调整 LRU 链表或 LFU 频率桶，而是把节点指针追加到当前线程对应的条带中，
+     * 攒够一批后由某个线程在独占锁下统一回放（drain），把维护成本分摊到多次访问上。
+     * - 每个线程按线程 id 固定落到一个条带，条带之间按缓存行对齐，不同线程互不干扰；
+     * - 缓冲是“有损”的：条带已满或与其他线程争抢同一位置失败时，本次访问记录直接丢弃。
+     *   丢弃只会让淘汰顺序略不精确，不影响正确性。
+     * 使用约定：record 必须在缓存的共享锁内调用，drain 必须在独占锁内调用，因此二者不会同时进行。
+     * 所有会释放节点的写操作都先在独占锁内 drain，缓冲中的指针因此永远指向仍然存活的节点。
+     * 读路径无锁的缓存（ConcurrentCache）在纪元保护下 record，用 drainConcurrent 回放，见其说明。
+     * @tparam Node 节点类型，缓冲中只保存 Node*
+     */
+    template<class Node>
+    class ReadBuffer
+    {
+    public:
+        static constexpr size_t STRIPES = 16;     // 条带数，2 的幂
+        static constexpr size_t STRIPE_SIZE = 16; // 每个条带的容量，2 的幂
+
+    private:
+        struct alignas(CACHE_LINE_SIZE) Stripe
+        {
+            std::atomic<uint32_t> head;  // 下一个待回放的位置（只在 drain 中推进）
+            std::atomic<uint32_t> tail;  // 下一个可写入的位置
+            std::atomic<Node*> slots[STRIPE_SIZE];
+            uint32_t owed;               // drainConcurrent 已计入但尚未取走的预留数（只由回放者访问）
+
+            Stripe() : head(0), tail(0), owed(0)
+            {
+                for(auto& slot : slots) slot.store(nullptr, std::memory_order_relaxed);
+            }
+        };
+
+        /**
+         * @brief 当前线程对应的条带下标，每个线程只计算一次
+         */
+        static size_t stripeIndex()
+        {
+            static thread_local size_t probe =
+                static_cast<size_t>(mixHash(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+            return probe & (STRIPES - 1);
+        }
+
+    public:
+        ReadBuffer() = default;
+        ReadBuffer(const ReadBuffer&) = delete;
+        ReadBuffer& operator=(const ReadBuffer&) = delete;
+
+        /**
+         * @brief 记录一次访问（调用方持有共享锁）
+         * @return 条带已满，调用方应尝试获取独占锁并 drain
+         */
+        bool record(Node* node)
+        {
+            Stripe& stripe = _stripes[stripeIndex()];
+            uint32_t tail = stripe.tail.load(std::memory_order_relaxed);
+            uint32_t size = tail - stripe.head.load(std::memory_order_relaxed);
+            if(size >= STRIPE_SIZE) return true; // 已满：丢弃本次记录
+            if(!stripe.tail.compare_exchange_strong(tail, tail + 1, std::memory_order_relaxed))
+            {
+                return false; // 与同条带的其他线程冲突：丢弃本次记录
+            }
+            stripe.slots[tail & (STRIPE_SIZE - 1)].store(node, std::memory_order_relaxed);
+            return size + 1 == STRIPE_SIZE;
+        }
+
+        /**
+         * @brief 按记录顺序回放所有条带中的访问（调用方持有独占锁）
+         */
+        template<class Fn>
+        void drain(Fn&& fn)
+        {
+            for(Stripe& stripe : _stripes)
+            {
+                uint32_t head = stripe.head.load(std::memory_order_relaxed);
+                uint32_t tail = stripe.tail.load(std::memory_order_relaxed);
+                for(; head != tail; ++head)
+                {
+                    std::atomic<Node*>& slot = stripe.slots[head & (STRIPE_SIZE - 1)];
+                    Node* node = slot.load(std::memory_order_relaxed);
+                    slot.store(nullptr, std::memory_order_relaxed);
+                    if(node) fn(node);
+                }
+                stripe.head.store(head, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief 是否有尚未回放的记录：只比较各条带的读写位置，供写者决定是否值得回放
+         * 不保证看到正在进行中的 record，需要完整取走时仍应调用 drainConcurrent
+         */
+        bool pending() const
+        {
+            for(const Stripe& stripe : _stripes)
+            {
+                if(stripe.tail.load(std::memory_order_relaxed) != stripe.head.load(std::memory_order_relaxed)) return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief 回放所有条带中的访问，可与 record 并发执行（调用方持有写锁，回放之间互斥）
+         * 不依赖 head / tail，而是逐个槽位取走指针：已预留但尚未写入的槽位这次取不到，
+         * 之后写入的指针会在下一次回放时取走或被后来的记录覆盖。
+         * 保证：调用开始前已经完成的 record，其指针在返回时都已交给 fn 或被覆盖丢弃，不会残留在缓冲中。
+         * 每个条带记着累计预留数与累计取走数之差（owed，只会高估），为 0 且没有新预留的条带不可能留有指针，
+         * 直接跳过：单个线程写满一个条带时只扫描这一个条带，而不是全部 STRIPES * STRIPE_SIZE 个槽位。
+         */
+        template<class Fn>
+        void drainConcurrent(Fn&& fn)
+        {
+            for(Stripe& stripe : _stripes)
+            {
+                uint32_t head = stripe.head.load(std::memory_order_relaxed);
+                uint32_t tail = stripe.tail.load(std::memory_order_relaxed);
+                uint32_t expected = stripe.owed + (tail - head);
+                if(expected == 0) continue;
+                uint32_t taken = 0;
+                for(uint32_t i = 0; i < STRIPE_SIZE; ++i)
+                {
+                    std::atomic<Node*>& slot = stripe.slots[(head + i) & (STRIPE_SIZE - 1)];
+                    if(!slot.load(std::memory_order_relaxed)) continue;
+                    Node* node = slot.exchange(nullptr, std::memory_order_relaxed);
+                    if(node)
+                    {
+                        fn(node);
+                        ++taken;
+                    }
+                }
+                // 取走的可能包含 tail 之后才预留的记录，它们下次计入预留数，这里截到 0 只会让 owed 偏大
+                stripe.owed = expected > taken ? expected - taken : 0;
+                stripe.head.store(tail, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        Stripe _stripes[STRIPES];
+    };
+}
+
+#endif
@@ -0,0 +1,87 @@
+// ShardArray.hpp
+
+#ifndef __SHARD_ARRAY_HPP__
+#define __SHARD_ARRAY_HPP__
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include "CacheHash.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 分片缓存的分片数组：所有分片放在一块连续内存中，每个分片按缓存行对齐并独占整数个缓存行
+     * 原先每个分片单独在堆上分配，相邻分片的锁与链表头可能落在同一缓存行，
+     * 不同线程操作不同分片时仍会互相使对方的缓存行失效（伪共享）。
+     * 分片在构造时一次建好，之后不增不减，因此分片类型不需要可移动（内含互斥量）。
+     * @tparam Shard 分片类型，如 LRUCache / LFUCache
+     * @tparam Padded 是否按缓存行对齐每个分片，默认对齐；取 false 时分片紧挨着存放，只用作伪共享的对照基准
+     */
+    template<class Shard, bool Padded = true>
+    class ShardArray
+    {
+    private:
+        struct alignas(Padded ? CACHE_LINE_SIZE : alignof(Shard)) Slot
+        {
+            Shard shard;
+
+            template<class... Args>
+            explicit Slot(const Args&... args) : shard(args...) {}
+        };
+
+        static constexpr std::align_val_t ALIGN{alignof(Slot)};
+
+    public:
+        /**
+         * @brief 构造 count 个分片，每个分片都以同一组参数 args 构造
+         */
+        template<class... Args>
+        explicit ShardArray(size_t count, const Args&... args)
+            : _slots(static_cast<Slot*>(::operator new(sizeof(Slot) * count, ALIGN))),
+              _count(0)
+        {
+            try
+            {
+                for(; _count < count; ++_count)
+                {
+                    new (&_slots[_count]) Slot(args...);
+                }
+            }
+            catch(...)
+            {
+                destroy();
+                throw;
+            }
+        }
+
+        ~ShardArray() { destroy(); }
+
+        ShardArray(const ShardArray&) = delete;
+        ShardArray& operator=(const ShardArray&) = delete;
+
+        Shard& operator[](size_t i) { return _slots[i].shard; }
+        const Shard& operator[](size_t i) const { return _slots[i].shard; }
+
+        size_t size() const { return _count; }
+
+    private:
+        /**
+         * @brief 逆序析构已构造的分片并释放内存
+         */
+        void destroy()
+        {
+            while(_count > 0)
+            {
+                _slots[--_count].~Slot();
+            }
+            ::operator delete(_slots, ALIGN);
+        }
+
+    private:
+        Slot* _slots;  // 连续的分片槽位，首地址按 alignof(Slot) 对齐
+        size_t _count; // 已构造的分片数
+    };
+}
+
+#endif
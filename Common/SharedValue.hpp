@@ -0,0 +1,50 @@
+// SharedValue.hpp
+
+#ifndef __SHARED_VALUE_HPP__
+#define __SHARED_VALUE_HPP__
+
+#include <memory>
+#include <utility>
+#include "CacheWeigher.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 共享只读值句柄
+     * 以 SharedValue<Value> 作为缓存的 Value 类型时，节点里保存的只是一个引用计数指针：
+     * get 在锁内只拷贝句柄（一次原子自增），真正的大对象在锁外由调用方直接读取，
+     * 分片锁的持有时间与值的大小无关。值是 const 的，因此多个读者共享同一份对象是安全的；
+     * 更新时写入一个新句柄即可，已取走旧句柄的读者仍然持有旧值直到自己释放。
+     * 未命中时 get(key) 返回空句柄（nullptr），可以直接用于判断是否命中。
+     */
+    template<class Value>
+    using SharedValue = std::shared_ptr<const Value>;
+
+    /**
+     * @brief 构造共享只读值（std::make_shared 的简写，对象与控制块一次分配）
+     */
+    template<class Value, class... Args>
+    SharedValue<Value> makeSharedValue(Args&&... args)
+    {
+        return std::make_shared<const Value>(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief 共享值句柄的权重函数
+     * 句柄本身只有两个指针大小，直接交给 ByteWeigher 会严重低估占用；
+     * 这里把句柄指向的对象交给内层权重函数计算，空句柄按内层对默认值的估算计。
+     * @tparam Inner 作用于 (Key, Value) 的权重函数，默认 ByteWeigher
+     */
+    template<class Key, class Value, class Inner = ByteWeigher<Key, Value>>
+    struct SharedValueWeigher
+    {
+        Inner inner;
+
+        size_t operator()(const Key& key, const SharedValue<Value>& value) const
+        {
+            return value ? inner(key, *value) : inner(key, Value());
+        }
+    };
+}
+
+#endif
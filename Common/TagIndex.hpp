@@ -0,0 +1,371 @@
+// TagIndex.hpp
+
+#ifndef __TAG_INDEX_HPP__
+#define __TAG_INDEX_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "CacheHash.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MYCACHE_TAG_INDEX_SSE2 1
+#endif
+
+namespace myCache
+{
+    /**
+     * @brief 批量查找时的预取距离：探测某个 Key 时，它后面 BATCH_PREFETCH_DISTANCE - 1 个 Key 的探测组已经在预取中
+     */
+    inline constexpr size_t BATCH_PREFETCH_DISTANCE = 8;
+
+    namespace detail
+    {
+        /**
+         * @brief 一组 16 个控制字节
+         * 控制字节取值：kEmpty（空）、kDeleted（墓碑）、0~127（占用，值为哈希的低 7 位“标签”）。
+         * 有 SSE2 时一条指令比较 16 个标签；否则逐字节比较，结果相同。
+         * 返回的都是 16 位掩码，第 i 位对应组内第 i 个槽位。
+         */
+        struct TagGroup
+        {
+            static constexpr size_t WIDTH = 16;
+            static constexpr int8_t kEmpty = -128;  // 0x80
+            static constexpr int8_t kDeleted = -2;  // 0xFE
+
+#ifdef MYCACHE_TAG_INDEX_SSE2
+            __m128i ctrl;
+
+            explicit TagGroup(const int8_t* pos)
+                : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)))
+            {}
+
+            uint32_t match(int8_t tag) const
+            {
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl)));
+            }
+
+            uint32_t matchEmpty() const
+            {
+                return match(kEmpty);
+            }
+
+            // 空槽位与墓碑的最高位都是 1，占用槽位最高位为 0，movemask 直接取出符号位
+            uint32_t matchEmptyOrDeleted() const
+            {
+                return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+            }
+#else
+            int8_t ctrl[WIDTH];
+
+            explicit TagGroup(const int8_t* pos)
+            {
+                std::memcpy(ctrl, pos, WIDTH);
+            }
+
+            uint32_t match(int8_t tag) const
+            {
+                uint32_t mask = 0;
+                for(size_t i = 0; i < WIDTH; ++i)
+                {
+                    if(ctrl[i] == tag) mask |= 1u << i;
+                }
+                return mask;
+            }
+
+            uint32_t matchEmpty() const
+            {
+                return match(kEmpty);
+            }
+
+            uint32_t matchEmptyOrDeleted() const
+            {
+                uint32_t mask = 0;
+                for(size_t i = 0; i < WIDTH; ++i)
+                {
+                    if(ctrl[i] < 0) mask |= 1u << i;
+                }
+                return mask;
+            }
+#endif
+        };
+
+        inline unsigned lowestBit(uint32_t mask)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+            unsigned i = 0;
+            while(!(mask & 1u)) { mask >>= 1; ++i; }
+            return i;
+#endif
+        }
+    }
+
+    /**
+     * @brief 按标签分组探测的哈希索引（Swiss table 风格）
+     * 每个槽位对应一个控制字节，保存哈希的低 7 位作为标签；每 16 个控制字节为一组，
+     * 查找时一次比较整组标签，只有标签相同（误判率约 1/128）的槽位才会去比较完整的 Key。
+     * 因此未命中通常只需读取一组控制字节就能判定，不会触碰任何缓存节点，
+     * 适合冷数据长尾（大量未命中）的访问模式。
+     * 接口与 FlatIndex 相同：映射值中自带 Key，由 KeyOf 取出；find 返回的槽位指针在下一次修改前有效。
+     * 删除时若所在组仍有空槽位则直接置空，否则留下墓碑；墓碑计入负载，达到上限时原地重建清除。
+     */
+    template<class Key, class Mapped, class KeyOf,
+             class Hash = CacheHash<Key>, class KeyEqual = CacheKeyEqual<Key>>
+    class TagIndex
+    {
+    public:
+        struct Slot
+        {
+            Mapped mapped;
+
+            Slot() : mapped() {}
+        };
+        typedef Slot* iterator;
+
+        /**
+         * @brief 混淆后的 64 位哈希，与 cacheHashOf 的结果一致（使用默认 Hash 时）
+         * 上层（如分片路由）已经算过同一个值时，可以通过 find / insert 的带哈希版本直接传入，避免重复计算
+         */
+        template<class K>
+        uint64_t hashOf(const K& key) const
+        {
+            return mixHash(static_cast<uint64_t>(_hash(key)));
+        }
+
+    private:
+        typedef detail::TagGroup Group;
+
+        static int8_t tagOf(uint64_t h) { return static_cast<int8_t>(h & 0x7F); }
+
+        // 组号由哈希的高位决定，与标签使用的低 7 位互不相关
+        size_t firstGroup(uint64_t h) const { return static_cast<size_t>(h >> 7) & _groupMask; }
+
+        /**
+         * @brief 找到 Key 应当写入的位置：探测序列上第一个空槽位或墓碑
+         */
+        size_t findInsertSlot(uint64_t h) const
+        {
+            size_t group = firstGroup(h);
+            for(size_t step = 1; ; ++step)
+            {
+                uint32_t mask = Group(&_ctrl[group * Group::WIDTH]).matchEmptyOrDeleted();
+                if(mask) return group * Group::WIDTH + detail::lowestBit(mask);
+                group = (group + step) & _groupMask; // 三角数步长，组数为 2 的幂时遍历所有组
+            }
+        }
+
+        void setSlot(size_t i, int8_t tag, Mapped&& mapped)
+        {
+            _ctrl[i] = tag;
+            _slots[i].mapped = std::move(mapped);
+        }
+
+        /**
+         * @brief 以 slotCount 个槽位重建整张表（扩容或清除墓碑）
+         */
+        void rehash(size_t slotCount)
+        {
+            std::vector<int8_t> oldCtrl;
+            std::vector<Slot> oldSlots;
+            oldCtrl.swap(_ctrl);
+            oldSlots.swap(_slots);
+
+            _ctrl.assign(slotCount, Group::kEmpty);
+            _slots.resize(slotCount);
+            _groupMask = slotCount / Group::WIDTH - 1;
+            _growthLeft = maxLoad(slotCount) - _size;
+
+            for(size_t i = 0; i < oldCtrl.size(); ++i)
+            {
+                if(oldCtrl[i] >= 0)
+                {
+                    uint64_t h = hashOf(_keyOf(oldSlots[i].mapped));
+                    setSlot(findInsertSlot(h), tagOf(h), std::move(oldSlots[i].mapped));
+                }
+            }
+        }
+
+        static size_t maxLoad(size_t slotCount) { return slotCount - slotCount / 8; } // 负载上限 7/8
+
+        static size_t slotCountFor(size_t count)
+        {
+            size_t slotCount = Group::WIDTH;
+            while(maxLoad(slotCount) < count) slotCount <<= 1;
+            return slotCount;
+        }
+
+    public:
+        explicit TagIndex(KeyOf keyOf = KeyOf(), Hash hash = Hash(), KeyEqual equal = KeyEqual())
+            : _size(0),
+              _growthLeft(0),
+              _groupMask(0),
+              _keyOf(keyOf),
+              _hash(hash),
+              _equal(equal)
+        {}
+
+        /**
+         * @brief 查找 Key（或其异构查找类型）
+         * 只读取表，不做任何修改：没有写者时多个线程可以同时查找
+         * @return 命中返回槽位指针，未命中返回 end()（空指针）
+         */
+        template<class K>
+        iterator find(const K& key)
+        {
+            return find(key, hashOf(key));
+        }
+
+        /**
+         * @brief 查找 Key，h 必须等于 hashOf(key)
+         */
+        template<class K>
+        iterator find(const K& key, uint64_t h)
+        {
+            if(_size == 0) return end();
+            int8_t tag = tagOf(h);
+            size_t group = firstGroup(h);
+            for(size_t step = 1; ; ++step)
+            {
+                Group g(&_ctrl[group * Group::WIDTH]);
+                for(uint32_t mask = g.match(tag); mask; mask &= mask - 1)
+                {
+                    size_t i = group * Group::WIDTH + detail::lowestBit(mask);
+                    if(_equal(_keyOf(_slots[i].mapped), key)) return &_slots[i];
+                }
+                // 组内还有空槽位，说明插入时探测不会越过这一组，可以断定不存在
+                if(g.matchEmpty()) return end();
+                group = (group + step) & _groupMask;
+            }
+        }
+
+        iterator end() const { return nullptr; }
+
+        /**
+         * @brief 预取 h 对应的首个探测组（控制字节与槽位起始处），供批量查找在探测前几步提前发出访存
+         * 只是提示，不读取也不修改表；表为空时什么都不做
+         */
+        void prefetch(uint64_t h) const
+        {
+            if(_ctrl.empty()) return;
+            size_t i = firstGroup(h) * Group::WIDTH;
+#if defined(MYCACHE_TAG_INDEX_SSE2)
+            _mm_prefetch(reinterpret_cast<const char*>(&_ctrl[i]), _MM_HINT_T0);
+            _mm_prefetch(reinterpret_cast<const char*>(&_slots[i]), _MM_HINT_T0);
+#elif defined(__GNUC__)
+            __builtin_prefetch(&_ctrl[i]);
+            __builtin_prefetch(&_slots[i]);
+#endif
+        }
+
+        /**
+         * @brief 批量探测的预取流水线：处理第 n 个 Key 之前调用
+         * n 为 0 时预取开头的 BATCH_PREFETCH_DISTANCE 个，之后每次补上第 n + BATCH_PREFETCH_DISTANCE - 1 个，
+         * 每个 Key 恰好预取一次；hashAt(k) 返回第 k 个 Key 的哈希
+         */
+        template<class HashAt>
+        void prefetchBatch(size_t n, size_t count, HashAt&& hashAt) const
+        {
+            if(n == 0)
+            {
+                for(size_t k = 0; k < count && k < BATCH_PREFETCH_DISTANCE; ++k) prefetch(hashAt(k));
+            }
+            else if(n + BATCH_PREFETCH_DISTANCE - 1 < count)
+            {
+                prefetch(hashAt(n + BATCH_PREFETCH_DISTANCE - 1));
+            }
+        }
+
+        /**
+         * @brief 插入一个映射值，其 Key 由 KeyOf 取出；调用方保证该 Key 尚不存在
+         */
+        void insert(Mapped mapped)
+        {
+            uint64_t h = hashOf(_keyOf(mapped));
+            insert(std::move(mapped), h);
+        }
+
+        /**
+         * @brief 插入一个映射值，h 必须等于 hashOf(其 Key)
+         */
+        void insert(Mapped mapped, uint64_t h)
+        {
+            if(_growthLeft == 0)
+            {
+                // 负载（含墓碑）已满：有效条目不多时原地重建清掉墓碑，否则扩容一倍
+                size_t slotCount = _ctrl.size();
+                if(slotCount == 0) slotCount = Group::WIDTH;
+                else if(_size + 1 > slotCount / 2) slotCount <<= 1;
+                rehash(slotCount);
+            }
+            size_t i = findInsertSlot(h);
+            if(_ctrl[i] == Group::kEmpty) _growthLeft--; // 复用墓碑不增加负载
+            setSlot(i, tagOf(h), std::move(mapped));
+            _size++;
+        }
+
+        void erase(iterator it)
+        {
+            size_t i = static_cast<size_t>(it - _slots.data());
+            size_t group = i / Group::WIDTH;
+            _slots[i].mapped = Mapped(); // 及时释放映射值持有的资源
+            // 组内原本就有空槽位时，任何探测都会在这一组停下，可以直接置空；否则必须留下墓碑
+            if(Group(&_ctrl[group * Group::WIDTH]).matchEmpty())
+            {
+                _ctrl[i] = Group::kEmpty;
+                _growthLeft++;
+            }
+            else
+            {
+                _ctrl[i] = Group::kDeleted;
+            }
+            _size--;
+        }
+
+        template<class K>
+        bool erase(const K& key)
+        {
+            iterator it = find(key);
+            if(it == end()) return false;
+            erase(it);
+            return true;
+        }
+
+        /**
+         * @brief 预留至少能容纳 count 个条目而不扩容的空间
+         */
+        void reserve(size_t count)
+        {
+            size_t slotCount = slotCountFor(count);
+            if(slotCount > _ctrl.size()) rehash(slotCount);
+        }
+
+        void clear()
+        {
+            _ctrl.clear();
+            _slots.clear();
+            _size = 0;
+            _growthLeft = 0;
+            _groupMask = 0;
+        }
+
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+    private:
+        std::vector<int8_t> _ctrl; // 控制字节，长度为槽位数（16 的倍数，2 的幂）
+        std::vector<Slot> _slots;  // 槽位数组，与控制字节一一对应
+        size_t _size;              // 有效条目数
+        size_t _growthLeft;        // 在触发重建前还能占用的空槽位数（墓碑不归还）
+        size_t _groupMask;         // 组数 - 1
+        KeyOf _keyOf;
+        Hash _hash;
+        KeyEqual _equal;
+    };
+}
+
+#endif
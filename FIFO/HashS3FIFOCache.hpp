@@ -0,0 +1,135 @@
+// HashS3FIFOCache.hpp
+
+#ifndef __HASH_S3FIFO_CACHE_HPP__
+#define __HASH_S3FIFO_CACHE_HPP__
+
+#include "S3FIFOCache.hpp"
+#include "../Common/ShardArray.hpp"
+#include <vector>
+#include <thread>
+#include <utility>
+
+namespace myCache
+{
+    /**
+     * @brief HashS3FIFOCache 模板类
+     * 与 HashLRUCache 相同的分片方式，每个分片是一个 S3FIFOCache（各自有 S、M 与幽灵队列）。
+     * 分片降低写操作之间的竞争；分片内部的读操作只取共享锁，读多写少时吞吐量随核心数增长。
+     * Weigher 会传递给每个分片，容量（权重预算）按分片均分。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class HashS3FIFOCache
+    {
+    private:
+        /**
+         * @brief 哈希定位函数：与分片内部索引相同的混淆哈希（cacheHashOf），取最高几位选择分片，
+         * 同一个值再传给分片的 *WithHash 接口作为索引哈希，每次操作只计算一次
+         */
+        template<class K>
+        uint64_t Hash(const K& key)
+        {
+            return cacheHashOf<Key>(key);
+        }
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 总缓存容量（所有条目权重之和的上限）
+         * @param sliceNum 分片数量，不大于 0 时取硬件并发核心数，向上取整为 2 的幂
+         * @param weigher 权重函数，默认每个条目计 1
+         */
+        HashS3FIFOCache(size_t capacity, int sliceNum, Weigher weigher = Weigher())
+            : _capacity(capacity),
+              _router(sliceNum),
+              // 容量向上取整均分到各分片，分片连续存放在按缓存行对齐的数组中
+              _s3fifoSliceCaches(_router.shardCount(), _router.perShard(capacity), weigher)
+        {}
+
+        void put(const Key& key, const Value& value)
+        {
+            uint64_t hash = Hash(key);
+            _s3fifoSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, value);
+        }
+
+        void put(const Key& key, Value&& value)
+        {
+            uint64_t hash = Hash(key);
+            _s3fifoSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, std::move(value));
+        }
+
+        bool get(const Key& key, Value& value)
+        {
+            uint64_t hash = Hash(key);
+            return _s3fifoSliceCaches[_router.shardOf(hash)].getWithHash(key, hash, value);
+        }
+
+        Value get(const Key& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            uint64_t hash = Hash(key);
+            return _s3fifoSliceCaches[_router.shardOf(hash)].getWithHash(key, hash, value);
+        }
+
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：在对应分片的共享锁内以 const 引用调用 fn(value)
+         * @return 是否命中
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            uint64_t hash = Hash(key);
+            return _s3fifoSliceCaches[_router.shardOf(hash)].visitWithHash(key, hash, std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不增加频次）
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            uint64_t hash = Hash(key);
+            return _s3fifoSliceCaches[_router.shardOf(hash)].containsWithHash(key, hash);
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        template<class K>
+        void remove(const K& key)
+        {
+            uint64_t hash = Hash(key);
+            _s3fifoSliceCaches[_router.shardOf(hash)].removeWithHash(key, hash);
+        }
+
+    private:
+        size_t _capacity; // 总容量
+        ShardRouter _router; // 分片路由：分片数为 2 的幂
+        ShardArray<S3FIFOCache<Key, Value, Weigher>> _s3fifoSliceCaches;
+    };
+
+    /**
+     * @brief 共享值模式的分片 S3-FIFO 缓存
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedHashS3FIFOCache = HashS3FIFOCache<Key, SharedValue<Value>, Weigher>;
+}
+
+#endif
@@ -0,0 +1,422 @@
+// S3FIFOCache.hpp
+
+#ifndef __S3FIFO_CACHE_HPP__
+#define __S3FIFO_CACHE_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../Common/CachePolicy.hpp"
+#include "../Common/CacheHash.hpp"
+#include "../Common/CacheWeigher.hpp"
+#include "../Common/TagIndex.hpp"
+#include "../Common/ArcGhostList.hpp"
+#include "../Common/SharedValue.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief S3-FIFO 缓存：三个 FIFO 队列组成的淘汰策略
+     * - 小队列 S（约 10% 容量）：新 Key 先进入这里。大多数 Key 只被访问一次，在 S 中停留很短时间就被淘汰；
+     *   出队时若在 S 中被访问过则移入主队列 M，否则淘汰并把指纹记入幽灵队列 G。
+     * - 主队列 M（其余容量）：出队时频次大于 0 的减 1 后重新入队（类似 CLOCK），频次为 0 的淘汰。
+     * - 幽灵队列 G：只保存最近从 S 淘汰的 Key 的指纹（ArcGhostList，记录数与 M 相当）；
+     *   再次写入时指纹命中则跳过 S 直接进入 M。
+     * 命中只把 2 位频次（0～3）原子地加 1，不移动任何队列，因此读操作只需共享锁；
+     * 入队、出队、淘汰只发生在写操作中，由独占锁保护。
+     * 条目存放在 deque 槽位中（与 ClockCache 相同，atomic 不可移动），两个队列以 32 位下标双向链接，支持 O(1) 删除。
+     * 容量按 Weigher 计算的权重累计，S / M / G 的配额同样按权重计算。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class S3FIFOCache : public CachePolicy<Key, Value>
+    {
+        typedef uint32_t Index;
+
+        // 两个队列各有一个哨兵，固定占用前 2 个槽位；哨兵的 _next 指向队首（最早入队），_prev 指向队尾
+        enum Queue : uint8_t { SMALL = 0, MAIN = 1 };
+        static constexpr Index SENTINEL_COUNT = 2;
+        static constexpr uint8_t MAX_FREQ = 3;
+
+        /**
+         * @brief 一个槽位
+         * 频次是唯一在共享锁下被修改的字段，其余字段只在独占锁下修改
+         */
+        struct Slot
+        {
+            Key _key;
+            Value _value;
+            size_t _weight;
+            Index _prev;
+            Index _next;
+            Queue _queue;
+            std::atomic<uint8_t> _freq; // 入队以来（M 中为上次出队以来）的访问次数，饱和于 MAX_FREQ
+
+            Slot() : _key(), _value(), _weight(0), _prev(0), _next(0), _queue(SMALL), _freq(0) {}
+        };
+
+        typedef std::deque<Slot> Pool;
+
+        struct SlotKeyOf
+        {
+            const Pool* pool;
+            const Key& operator()(Index idx) const { return (*pool)[idx]._key; }
+        };
+        typedef TagIndex<Key, Index, SlotKeyOf> NodeMap;
+
+    private:
+        /**
+         * @brief 记录一次访问：已饱和时不再写入，避免多个读线程反复写同一缓存行
+         * 并发读之间的自增可能互相覆盖而少计，对 2 位频次的近似没有影响
+         */
+        static void touch(Slot& slot)
+        {
+            uint8_t freq = slot._freq.load(std::memory_order_relaxed);
+            if(freq < MAX_FREQ)
+            {
+                slot._freq.store(freq + 1, std::memory_order_relaxed);
+            }
+        }
+
+        void unlink(Index idx)
+        {
+            Slot& slot = _pool[idx];
+            _pool[slot._prev]._next = slot._next;
+            _pool[slot._next]._prev = slot._prev;
+            _queueWeight[slot._queue] -= slot._weight;
+        }
+
+        /**
+         * @brief 挂到 queue 的队尾
+         */
+        void pushBack(Index idx, Queue queue)
+        {
+            Slot& slot = _pool[idx];
+            Slot& sentinel = _pool[queue];
+            slot._queue = queue;
+            slot._prev = sentinel._prev;
+            slot._next = queue;
+            _pool[sentinel._prev]._next = idx;
+            sentinel._prev = idx;
+            _queueWeight[queue] += slot._weight;
+        }
+
+        /**
+         * @brief queue 的队首（最早入队），队列为空时返回哨兵自身
+         */
+        Index frontOf(Queue queue) const { return _pool[queue]._next; }
+
+        Index acquireSlot()
+        {
+            if(_freeSlots.empty())
+            {
+                _pool.emplace_back();
+                return static_cast<Index>(_pool.size() - 1);
+            }
+            Index idx = _freeSlots.back();
+            _freeSlots.pop_back();
+            return idx;
+        }
+
+        /**
+         * @brief 从所在队列与索引中删除条目，归还槽位，并及时释放值占用的资源
+         */
+        void eraseSlot(Index idx)
+        {
+            unlink(idx);
+            Slot& slot = _pool[idx];
+            _nodeMap.erase(slot._key);
+            _usedWeight -= slot._weight;
+            slot._weight = 0;
+            slot._freq.store(0, std::memory_order_relaxed);
+            slot._value = Value();
+            _freeSlots.push_back(idx);
+        }
+
+        /**
+         * @brief S 出队一个条目：被访问过的移入 M（频次清零），否则淘汰并记入幽灵队列
+         */
+        void evictSmall()
+        {
+            Index idx = frontOf(SMALL);
+            Slot& slot = _pool[idx];
+            if(slot._freq.load(std::memory_order_relaxed) > 0)
+            {
+                slot._freq.store(0, std::memory_order_relaxed);
+                unlink(idx);
+                pushBack(idx, MAIN);
+                return;
+            }
+            _ghost.add(slot._key, slot._weight);
+            eraseSlot(idx);
+        }
+
+        /**
+         * @brief M 出队一个条目：频次大于 0 的减 1 后重新入队（第二次机会），否则淘汰
+         */
+        void evictMain()
+        {
+            Index idx = frontOf(MAIN);
+            Slot& slot = _pool[idx];
+            uint8_t freq = slot._freq.load(std::memory_order_relaxed);
+            if(freq > 0)
+            {
+                slot._freq.store(freq - 1, std::memory_order_relaxed);
+                unlink(idx);
+                pushBack(idx, MAIN);
+                return;
+            }
+            eraseSlot(idx);
+        }
+
+        /**
+         * @brief 淘汰直到总权重不超过 limit：S 超出自己的配额或 M 为空时从 S 出队，否则从 M 出队
+         * S 中的条目最多移动一次，M 中的条目最多被跳过 MAX_FREQ 次，循环必然结束；两个队列都空时停止。
+         */
+        void evictUntil(size_t limit)
+        {
+            while(_usedWeight > limit)
+            {
+                bool smallEmpty = frontOf(SMALL) == SMALL;
+                bool mainEmpty = frontOf(MAIN) == MAIN;
+                if(smallEmpty && mainEmpty) return;
+                if(!smallEmpty && (mainEmpty || _queueWeight[SMALL] > _smallCapacity)) evictSmall();
+                else evictMain();
+            }
+        }
+
+    public:
+        /**
+         * @brief 初始化缓存
+         * S 占容量的 10%（至少 1），其余为 M；幽灵队列记录的权重与 M 的配额相同。
+         * @param capacity 缓存容量上限（所有条目权重之和的上限）
+         * @param weigher 权重函数，默认每个条目计 1
+         */
+        S3FIFOCache(size_t capacity, Weigher weigher = Weigher())
+            : _capacity(capacity),
+              _smallCapacity(capacity > 1 ? std::max<size_t>(1, capacity / 10) : capacity),
+              _usedWeight(0),
+              _queueWeight{0, 0},
+              _weigher(weigher),
+              _nodeMap(SlotKeyOf{&_pool}),
+              _ghost(capacity - _smallCapacity)
+        {
+            for(Index q = 0; q < SENTINEL_COUNT; ++q)
+            {
+                _pool.emplace_back();
+                _pool[q]._prev = q;
+                _pool[q]._next = q;
+            }
+            if(std::is_same<Weigher, UnitWeigher<Key, Value>>::value)
+            {
+                _nodeMap.reserve(_capacity);
+            }
+        }
+
+        ~S3FIFOCache() override = default;
+
+        void put(const Key& key, const Value& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), value);
+        }
+
+        void put(const Key& key, Value&& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), std::move(value));
+        }
+
+        /**
+         * @brief 读取数据：共享锁 + 原子地增加频次，不移动任何队列
+         */
+        bool get(const Key& key, Value& value) override
+        {
+            return visitWithHash(key, _nodeMap.hashOf(key), [&value](const Value& stored) { value = stored; });
+        }
+
+        Value get(const Key& key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            return visitWithHash(key, _nodeMap.hashOf(key), [&value](const Value& stored) { value = stored; });
+        }
+
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：命中时在共享锁内以 const 引用调用 fn(value)
+         * 对缓存的影响与 get 相同（频次加 1）。fn 可能与其他读线程的 fn 并发执行，
+         * 且不能再写本缓存，否则会死锁。
+         * @return 是否命中
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            return visitWithHash(key, _nodeMap.hashOf(key), std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 带预先算好哈希的读写接口，供分片路由复用同一个哈希值
+         * hash 必须等于 cacheHashOf<Key>(key)，否则查找结果未定义
+         */
+        template<class K>
+        bool getWithHash(const K& key, uint64_t hash, Value& value)
+        {
+            return visitWithHash(key, hash, [&value](const Value& stored) { value = stored; });
+        }
+
+        template<class K, class Fn>
+        bool visitWithHash(const K& key, uint64_t hash, Fn&& fn)
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            auto it = _nodeMap.find(key, hash);
+            if(it == _nodeMap.end()) return false;
+            Slot& slot = _pool[it->mapped];
+            touch(slot);
+            fn(static_cast<const Value&>(slot._value));
+            return true;
+        }
+
+        template<class K>
+        bool containsWithHash(const K& key, uint64_t hash)
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            return _nodeMap.find(key, hash) != _nodeMap.end();
+        }
+
+        template<class K>
+        void removeWithHash(const K& key, uint64_t hash)
+        {
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            auto it = _nodeMap.find(key, hash);
+            if(it != _nodeMap.end())
+            {
+                eraseSlot(it->mapped);
+            }
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, const Value& value)
+        {
+            putImpl(key, hash, value);
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, Value&& value)
+        {
+            putImpl(key, hash, std::move(value));
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不增加频次）
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            return containsWithHash(key, _nodeMap.hashOf(key));
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项（不记入幽灵队列）
+         */
+        template<class K>
+        void remove(const K& key)
+        {
+            removeWithHash(key, _nodeMap.hashOf(key));
+        }
+
+        /**
+         * @brief 当前已占用的权重总和
+         */
+        size_t usedWeight()
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            return _usedWeight;
+        }
+
+    private:
+        /**
+         * @brief 写入逻辑：两个 put 重载共用，value 按原本的值类别转发（左值拷贝、右值移动）
+         * 新 Key 的指纹在幽灵队列中时直接进入 M，否则进入 S；先腾出空间再入队，新条目不会被自己挤掉。
+         */
+        template<class V>
+        void putImpl(const Key& key, uint64_t h, V&& value)
+        {
+            if(_capacity == 0) return;
+            size_t weight = _weigher(key, value);
+
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            auto it = _nodeMap.find(key, h);
+            if(weight > _capacity)
+            {
+                // 单个条目超过整个预算，无法存放：拒绝写入，同时丢弃旧值避免读到过期数据
+                if(it != _nodeMap.end()) eraseSlot(it->mapped);
+                return;
+            }
+            if(it != _nodeMap.end())
+            {
+                Index idx = it->mapped;
+                Slot& slot = _pool[idx];
+                Queue queue = slot._queue;
+                slot._value = std::forward<V>(value);
+                touch(slot);
+                // 新值更重时淘汰其他条目：先把它摘出队列，淘汰期间不会轮到它，之后放回原队列的队尾
+                unlink(idx);
+                _usedWeight = _usedWeight - slot._weight + weight;
+                slot._weight = weight;
+                evictUntil(_capacity);
+                pushBack(idx, queue);
+                return;
+            }
+
+            evictUntil(_capacity - weight);
+            Queue queue = _ghost.remove(key) ? MAIN : SMALL;
+            Index idx = acquireSlot();
+            Slot& slot = _pool[idx];
+            slot._key = key;
+            slot._value = std::forward<V>(value);
+            slot._weight = weight;
+            slot._freq.store(0, std::memory_order_relaxed);
+            _usedWeight += weight;
+            pushBack(idx, queue);
+            _nodeMap.insert(idx, h);
+        }
+
+    private:
+        size_t _capacity;               // 缓存最大容量（权重预算）
+        size_t _smallCapacity;          // 小队列 S 的配额
+        size_t _usedWeight;             // 当前已占用的权重
+        size_t _queueWeight[2];         // S / M 各自占用的权重
+        Weigher _weigher;               // 条目权重函数
+        Pool _pool;                     // 槽位，下标 0 / 1 为 S / M 的哨兵
+        std::vector<Index> _freeSlots;  // 空闲槽位下标
+        NodeMap _nodeMap;               // 标签分组索引：Key -> 槽位下标
+        ArcGhostList<Key> _ghost;       // 幽灵队列 G：最近从 S 淘汰的 Key 的指纹
+        alignas(CACHE_LINE_SIZE) std::shared_mutex _mutex; // 读写锁：读共享，写独占；独占缓存行，加解锁不会使索引所在行失效
+    };
+
+    /**
+     * @brief 共享值模式的 S3-FIFO 缓存：共享锁内只拷贝句柄
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedS3FIFOCache = S3FIFOCache<Key, SharedValue<Value>, Weigher>;
+}
+
+#endif
@@ -10,8 +10,9 @@
 #include <climits>
 #include <vector>
 #include <thread>
-#include <cmath>
 #include "LFUCache.hpp"
+#include "../Common/ShardArray.hpp"
+#include "../Common/CapacityBalancer.hpp"
  
 namespace myCache
 {
@@ -20,50 +21,62 @@ namespace myCache
      * 核心思想：通过哈希分片降低锁粒度。
      * 适用场景：高并发环境。传统的单锁 LFU 在多核 CPU 下会因为锁竞争成为性能瓶颈，
      * 分片方案可以将冲突概率降低到原来的 1/sliceNum。
+     * Weigher 会传递给每个分片，容量（权重预算）按分片均分；开启 adaptiveCapacity 后，
+     * 配额会按各分片的未命中压力在分片之间挪动（见 CapacityBalancer）。
      */
-    template <class Key, class Value>
+    template <class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
     class HashLFUCache
     {
     private:
         /**
          * @brief 哈希定位函数
-         * 使用标准库提供的 hash 对象将 Key 映射为无符号整数
+         * 使用与分片内部索引完全相同的混淆哈希（cacheHashOf），异构查找类型会被路由到同一个分片；
+         * 算出的哈希值随请求一起交给分片，分片内部不再重复计算
          */
-        size_t Hash(Key key)
+        template <class K>
+        uint64_t Hash(const K& key)
         {
-            std::hash<Key> hashFunc;
-            return hashFunc(key);
+            return cacheHashOf<Key>(key);
         }
  
     public:
         /**
          * @brief 构造函数
          * @param capacity 整个缓存的总容量
-         * @param sliceNum 分片数量。若传入 0 或负数，则自动设为硬件支持的并发线程数。
+         * @param sliceNum 分片数量。若传入 0 或负数，则自动设为硬件支持的并发线程数；最终向上取整为 2 的幂。
          * @param maxAverageNum LFU 内部老化机制的阈值，用于防止“频率老龄化”
+         * @param weigher 权重函数，默认每个条目计 1（此时 capacity 即条目数上限）
+         * @param bufferedReads 是否为每个分片开启读缓冲（见 LFUCache）
+         * @param adaptiveCapacity 是否按未命中压力在分片之间再分配容量，总容量保持不变
          */
-        HashLFUCache(size_t capacity, int sliceNum, int maxAverageNum = 10)
-            : _sliceNum(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency()),
-              _capacity(capacity)    
-        {
-            // 均匀分配容量：计算每个分片应有的容量上限（向上取整）
-            size_t sliceSize = std::ceil(_capacity / static_cast<double>(_sliceNum));
-            
-            // 初始化分片容器，装载独占的子 LFU 缓存
-            for(int i = 0; i < _sliceNum; i++)
-            {
-                _LFUSliceCaches.emplace_back(std::make_shared<LFUCache<Key, Value>>(sliceSize, maxAverageNum));
-            }
-        }
+        HashLFUCache(size_t capacity, int sliceNum, int maxAverageNum = 10, Weigher weigher = Weigher(), bool bufferedReads = false,
+                     bool adaptiveCapacity = false)
+            : _capacity(capacity),
+              _router(sliceNum),
+              // 均匀分配容量（向上取整），分片连续存放在按缓存行对齐的数组中
+              _LFUSliceCaches(_router.shardCount(), _router.perShard(capacity), maxAverageNum, weigher, bufferedReads),
+              _balancer(adaptiveCapacity && _router.shardCount() > 1
+                        ? std::make_unique<CapacityBalancer>(_router.shardCount(), _router.perShard(capacity))
+                        : nullptr)
+        {}
  
         /**
          * @brief 写入数据
          * 根据 Key 的哈希值找到对应的分片，然后将写操作委托给该分片
          */
-        void put(Key key, Value value)
+        void put(const Key& key, const Value& value)
+        {
+            uint64_t hash = Hash(key);
+            _LFUSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, value);
+        }
+ 
+        /**
+         * @brief 写入数据（右值版本），值一路移动到分片的节点中
+         */
+        void put(const Key& key, Value&& value)
         {
-            size_t sliceIndex = Hash(key) % _sliceNum;
-            _LFUSliceCaches[sliceIndex]->put(key, value);
+            uint64_t hash = Hash(key);
+            _LFUSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, std::move(value));
         }
  
         /**
@@ -72,41 +85,175 @@ namespace myCache
          * @param value 输出参数，用于接收找到的值
          * @return bool 是否命中缓存
          */
-        bool get(Key key, Value& value)
+        bool get(const Key& key, Value& value)
         {
-            size_t sliceIndex = Hash(key) % _sliceNum;
-            return _LFUSliceCaches[sliceIndex]->get(key, value);
+            uint64_t hash = Hash(key);
+            size_t sliceIndex = _router.shardOf(hash);
+            if(_LFUSliceCaches[sliceIndex].getWithHash(key, hash, value)) return true;
+            recordMiss(sliceIndex, hash);
+            return false;
         }
  
         /**
          * @brief 获取数据（直接返回）
          * 若未命中则返回 Value 类型的默认构造值
          */
-        Value get(Key key)
+        Value get(const Key& key)
         {
             Value value{}; // 使用值初始化确保安全
             get(key, value);
             return value;
         }
  
+        /**
+         * @brief 免拷贝读取：在对应分片的锁内以 const 引用调用 fn(value)
+         * @return bool 是否命中缓存
+         */
+        template <class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            uint64_t hash = Hash(key);
+            size_t sliceIndex = _router.shardOf(hash);
+            if(_LFUSliceCaches[sliceIndex].visitWithHash(key, hash, std::forward<Fn>(fn))) return true;
+            recordMiss(sliceIndex, hash);
+            return false;
+        }
+ 
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template <class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            uint64_t hash = Hash(key);
+            size_t sliceIndex = _router.shardOf(hash);
+            if(_LFUSliceCaches[sliceIndex].getWithHash(key, hash, value)) return true;
+            recordMiss(sliceIndex, hash);
+            return false;
+        }
+ 
+        template <class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+ 
+        /**
+         * @brief 批量读取：一次算好全部哈希，按分片分组，每个分片只加一次锁（组内提前预取索引）
+         * @param values 输出数组，长度不小于 count；命中的位置写入值，未命中的位置保持不变
+         * @param found 输出数组（可为空），记录每个位置是否命中
+         * @return 命中个数
+         */
+        size_t multiGet(const Key* keys, size_t count, Value* values, bool* found = nullptr)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = Hash(keys[i]);
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> offsets;
+            _router.group(hashes.data(), count, order, offsets);
+ 
+            std::vector<char> hit(count, 0);
+            size_t hits = 0;
+            for(size_t s = 0; s < _router.shardCount(); ++s)
+            {
+                size_t begin = offsets[s];
+                size_t n = offsets[s + 1] - begin;
+                if(n == 0) continue;
+                hits += _LFUSliceCaches[s].visitBatchWithHash(keys, hashes.data(), order.data() + begin, n,
+                    [values, &hit](size_t i, const Value& stored)
+                    {
+                        values[i] = stored;
+                        hit[i] = 1;
+                    });
+            }
+            // 所有分片锁都已释放，再统一记录未命中（可能触发容量再分配）
+            for(size_t i = 0; i < count; ++i)
+            {
+                if(found) found[i] = hit[i] != 0;
+                if(!hit[i]) recordMiss(_router.shardOf(hashes[i]), hashes[i]);
+            }
+            return hits;
+        }
+ 
+        /**
+         * @brief 批量写入：一次算好全部哈希，按分片分组，每个分片只加一次锁
+         */
+        void multiPut(const std::pair<Key, Value>* entries, size_t count)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = Hash(entries[i].first);
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> offsets;
+            _router.group(hashes.data(), count, order, offsets);
+ 
+            for(size_t s = 0; s < _router.shardCount(); ++s)
+            {
+                size_t begin = offsets[s];
+                size_t n = offsets[s + 1] - begin;
+                if(n == 0) continue;
+                _LFUSliceCaches[s].putBatchWithHash(entries, hashes.data(), order.data() + begin, n);
+            }
+        }
+ 
+        /**
+         * @brief 判断 Key 是否在缓存中（不影响访问频次）
+         */
+        template <class K>
+        bool contains(const K& key)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            return _LFUSliceCaches[sliceIndex].contains(key);
+        }
+ 
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        template <class K>
+        void remove(const K& key)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            _LFUSliceCaches[sliceIndex].remove(key);
+        }
+ 
         /**
          * @brief 清空所有分片缓存
          * 遍历每一个子 LFU 缓存并执行其清理逻辑
          */
         void purge()
         {
-            for(auto& cache : _LFUSliceCaches)
+            for(size_t i = 0; i < _LFUSliceCaches.size(); i++)
             {
-                cache->purge();
+                _LFUSliceCaches[i].purge();
             }
         }
         
+    private:
+        /**
+         * @brief 未命中时记录分片压力，到达间隔时在当前线程内再分配容量（此时不持有任何分片锁）
+         */
+        void recordMiss(size_t sliceIndex, uint64_t hash)
+        {
+            if(_balancer && _balancer->recordMiss(sliceIndex, hash))
+            {
+                _balancer->rebalance([this](size_t i, size_t capacity) { _LFUSliceCaches[i].setCapacity(capacity); });
+            }
+        }
+ 
     private:
         size_t _capacity; // 缓存总额度
-        int _sliceNum;    // 分片数量
-        // 存储切片 LFU 缓存的容器，使用智能指针管理生命周期
-        std::vector<std::shared_ptr<LFUCache<Key, Value>>> _LFUSliceCaches; 
+        ShardRouter _router; // 分片路由：分片数为 2 的幂
+        // 所有分片连续存放，每个分片独占整数个缓存行，相邻分片之间没有伪共享
+        ShardArray<LFUCache<Key, Value, Weigher>> _LFUSliceCaches;
+        std::unique_ptr<CapacityBalancer> _balancer; // 容量再分配，未开启时为空
     };
+ 
+    /**
+     * @brief 共享值模式的分片 LFU：分片锁内只拷贝句柄
+     */
+    template <class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedHashLFUCache = HashLFUCache<Key, SharedValue<Value>, Weigher>;
 }
  
 #endif
\ No newline at end of file
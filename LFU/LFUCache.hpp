@@ -3,17 +3,23 @@
 #ifndef __LFUCACHE_HPP__
 #define __LFUCACHE_HPP__
  
+#include <algorithm>
 #include <iostream>
 #include <memory>
-#include <unordered_map>
 #include <mutex>
-#include <climits>
+#include <utility>
+#include <vector>
 #include "../Common/CachePolicy.hpp"
+#include "../Common/CacheHash.hpp"
+#include "../Common/CacheWeigher.hpp"
+#include "../Common/TagIndex.hpp"
+#include "../Common/ReadBuffer.hpp"
+#include "../Common/SharedValue.hpp"
  
 namespace myCache
 {
     // 前向声明，方便 FreqList 引用
-    template <class Key, class Value> class LFUCache;
+    template <class Key, class Value, class Weigher = UnitWeigher<Key, Value>> class LFUCache;
  
     /**
      * @brief 频率链表类
@@ -22,37 +28,57 @@ namespace myCache
     template <class Key, class Value>
     class FreqList
     {
-        friend class LFUCache<Key, Value>;
+        template <class K, class V, class W>
+        friend class LFUCache;
  
     private:
         // 节点结构：包含数据本身、访问频率以及双向指针
         struct Node
         {
-            int freq;           // 当前节点的访问频次
+            size_t freq;        // 当前节点的存储频次（有效频次 = freq - 全局衰减偏移，见 LFUCache）
             Key key;
             Value value;
             std::weak_ptr<Node> pre;   // 前驱指针（弱引用防止循环计数）
             std::shared_ptr<Node> next;// 后继指针
+            FreqList* list;            // 节点当前所在的频率链表，升频时直接由此出发，无需查表
+            size_t weight;             // 节点计入容量的权重（由 Weigher 计算）
  
-            Node() : freq(1), next(nullptr) {}
-            Node(Key key, Value value) : freq(1), key(key), value(value), next(nullptr) {}
+            Node() : freq(1), next(nullptr), list(nullptr), weight(0) {}
+            Node(Key key, Value value) : freq(1), key(std::move(key)), value(std::move(value)), next(nullptr), list(nullptr), weight(0) {}
         };
  
         typedef std::shared_ptr<Node> NodePtr;
-        int _freq;     // 本链表对应的统一频率
-        NodePtr _head; // 哨兵头节点（不存数据）
-        NodePtr _tail; // 哨兵尾节点（不存数据）
+        size_t _freq;         // 本链表对应的统一（存储）频率
+        NodePtr _head;        // 哨兵头节点（不存数据）
+        NodePtr _tail;        // 哨兵尾节点（不存数据）
+        FreqList* _prevList;  // 频率链中的前一个非空链表（频率更低）
+        FreqList* _nextList;  // 频率链中的后一个非空链表（频率更高）
  
     public:
-        explicit FreqList(int freq)
+        explicit FreqList(size_t freq)
             : _freq(freq),
               _head(std::make_shared<Node>()),
-              _tail(std::make_shared<Node>())
+              _tail(std::make_shared<Node>()),
+              _prevList(nullptr),
+              _nextList(nullptr)
         {
             _head->next = _tail;
             _tail->pre = _head;
         }
  
+        /**
+         * @brief 逐个断开 next 链接后再释放，避免长链表递归析构导致栈溢出
+         */
+        ~FreqList()
+        {
+            NodePtr node = _head;
+            while(node)
+            {
+                NodePtr next = std::move(node->next);
+                node = std::move(next);
+            }
+        }
+ 
         // 检查当前频率下是否还有节点
         bool isEmpty() const { return _head->next == _tail; }
  
@@ -60,6 +86,7 @@ namespace myCache
         void addNode(NodePtr node)
         {
             if (!node || !_head || !_tail) return;
+            node->list = this;
             node->pre = _tail->pre;
             node->next = _tail;
             _tail->pre.lock()->next = node;
@@ -75,6 +102,7 @@ namespace myCache
             pre->next = node->next;
             node->next->pre = pre;
             node->next = nullptr; 
+            node->list = nullptr;
         }
  
         // 获取该频率下“最老”的节点（用于淘汰）
@@ -83,78 +111,210 @@ namespace myCache
  
     /**
      * @brief LFU 缓存核心类
+     * 容量按 Weigher 计算的权重累计：默认每个条目权重为 1（即条目数上限）。
+     * 开启读缓冲（bufferedReads）后，命中只在共享锁下查找并把节点记入 ReadBuffer，
+     * 升频攒批后在独占锁下统一回放。这只是把频率桶的修改攒批，命中仍要对锁字做一次原子读-改-写。
      */
-    template <class Key, class Value>
+    template <class Key, class Value, class Weigher>
     class LFUCache : public CachePolicy<Key, Value>
     {
     public:
         typedef typename FreqList<Key, Value>::Node Node;
         typedef std::shared_ptr<Node> NodePtr;
-        typedef std::unordered_map<Key, NodePtr> NodeMap;
+
+        // 索引中只存节点指针，Key 直接从节点中取
+        struct NodeKeyOf
+        {
+            const Key& operator()(const NodePtr& node) const { return node->key; }
+        };
+        typedef TagIndex<Key, NodePtr, NodeKeyOf> NodeMap;
  
     private:
+        /**
+         * @brief 当前衰减纪元下节点的有效频次
+         * 老化只推进全局偏移 _freqOffset，节点自身的 freq 不变：
+         * 有效频次 = freq - _freqOffset，最低为 1（与原先“整体减半后不低于 1”的语义一致）
+         */
+        size_t effectiveFreq(const NodePtr& node) const
+        {
+            return node->freq > _freqOffset ? node->freq - _freqOffset : 1;
+        }
+
         /**
          * @brief 内部写入逻辑
          * 处理新成员入场或满员踢人
          */
-        void putInternal(Key key, Value value)
+        template <class V>
+        void putInternal(const Key& key, V&& value, size_t weight, uint64_t hash)
         {
-            if(_nodeMap.size() == _capacity)
+            while(!_nodeMap.empty() && _usedWeight + weight > _capacity)
+            {
+                // 缓存满：踢掉频率最低且最久没用的那个，直到能容纳新节点
+                kickOut(nullptr);
+            }
+            NodePtr node = std::make_shared<Node>(key, std::forward<V>(value));
+            node->freq = _freqOffset + 1; // 有效频次为 1
+            node->weight = weight;
+            _usedWeight += weight;
+            _nodeMap.insert(node, hash);
+
+            // 有效频次为 1 的链表必然是锚点本身或紧跟在锚点之后
+            FreqList<Key, Value>* list = _anchor;
+            if(!list || list->_freq != node->freq)
             {
-                // 缓存满：踢掉频率最低且最久没用的那个
-                kickOut();
+                list = acquireFreqList(node->freq);
+                linkFreqList(list, _anchor);
             }
-            NodePtr node = std::make_shared<Node>(key, value);
-            _nodeMap[key] = node;
-            addToFreqList(node); // 加入频率为 1 的链表
+            _anchor = list;
+            list->addNode(node);
             addFreqNum();        // 更新全局统计信息
-            _minFreq = 1;        // 新成员进来，最小频率肯定重置为 1
         }
  
         /**
          * @brief 内部读取逻辑
-         * 负责数据的频率升级（从当前链表移动到 freq+1 的链表）
+         * 负责数据的频率升级（从当前链表移动到有效频次 + 1 的链表），值的读取由调用方完成
          */
-        void getInternal(NodePtr node, Value &value)
-        {
-            value = node->value;
-            removeFromFreqList(node); // 从原频率链表移除
-            node->freq++;             // 频率加 1
-            addToFreqList(node);      // 加入新频率链表
-            
-            // 如果原本最小频率的链表空了，且刚升级的节点就是之前的最小频率节点，更新全局最小频率
-            if(_minFreq == node->freq - 1 && _freqToFreqList[node->freq - 1]->isEmpty())
-                _minFreq++;
-                
+        void getInternal(const NodePtr& node)
+        {
+            FreqList<Key, Value>* oldList = node->list;
+            FreqList<Key, Value>* target;
+
+            if(node->freq > _freqOffset)
+            {
+                // 常规情况：目标链表只可能是频率链上的下一个
+                node->freq++;
+                target = oldList->_nextList;
+                if(!target || target->_freq != node->freq)
+                {
+                    target = acquireFreqList(node->freq);
+                    linkFreqList(target, oldList);
+                }
+            }
+            else
+            {
+                // 节点在上次衰减后尚未被访问过（有效频次被钳制为 1）：
+                // 在这里把它对齐到当前纪元，目标频次为 2，位置紧跟在锚点链表之后
+                node->freq = _freqOffset + 2;
+                target = _anchor->_nextList;
+                if(!target || target->_freq != node->freq)
+                {
+                    target = acquireFreqList(node->freq);
+                    linkFreqList(target, _anchor);
+                }
+            }
+
+            oldList->removeNode(node);
+            target->addNode(node);
+            if(oldList->isEmpty())
+                unlinkFreqList(oldList);
+
             addFreqNum(); // 更新平均值统计
         }
  
-        // 淘汰逻辑：寻找最小频率链表中的第一个节点删除
-        void kickOut()
+        /**
+         * @brief 回放读缓冲中记录的访问（调用方持有独占锁）
+         * 仍在频率链表中的节点由其前驱的 next 取得共享指针后升频；已被删除的节点 list 为空，直接跳过。
+         */
+        void drainReadBuffer()
         {
-            NodePtr node = _freqToFreqList[_minFreq]->getFirstNode();
-            int decreaseNum = node->freq;
-            _nodeMap.erase(node->key);
-            removeFromFreqList(node);
-            decreaseFreqNum(decreaseNum); // 更新总频次
+            if(!_readBuffer) return;
+            _readBuffer->drain([this](Node* node)
+            {
+                if(!node->list) return;
+                NodePtr ptr = node->pre.lock()->next; // 拷贝一份：升频时前驱的 next 会被改写
+                getInternal(ptr);
+            });
         }
- 
-        void removeFromFreqList(NodePtr node)
+
+        /**
+         * @brief 读缓冲某个条带已满：抢得到独占锁就顺手回放，抢不到交给正在写的线程
+         */
+        void tryDrainReadBuffer()
         {
-            if(!node) return;
-            _freqToFreqList[node->freq]->removeNode(node);
+            std::unique_lock<CacheMutex> lock(_mutex, std::try_to_lock);
+            if(lock.owns_lock()) drainReadBuffer();
         }
- 
-        void addToFreqList(NodePtr node)
+
+        /**
+         * @brief 淘汰逻辑：频率链首（最小频率）链表中的第一个节点
+         * @param exclude 不允许被淘汰的节点（刚更新过的节点），为空表示不限制
+         */
+        void kickOut(const NodePtr& exclude)
+        {
+            NodePtr node = _minFreqList->getFirstNode();
+            if(node == exclude)
+            {
+                // 跳过被保护的节点：取同一链表中的下一个，链表只有它时取下一个链表的首节点
+                node = node->next;
+                if(!node->next)
+                {
+                    if(!_minFreqList->_nextList) return;
+                    node = _minFreqList->_nextList->getFirstNode();
+                }
+            }
+            eraseNode(node);
+        }
+
+        /**
+         * @brief 将节点从频率链表和 map 中彻底删除，并归还其频次与权重
+         */
+        void eraseNode(NodePtr node)
+        {
+            FreqList<Key, Value>* list = node->list;
+            int decreaseNum = static_cast<int>(effectiveFreq(node));
+            _usedWeight -= node->weight;
+            _nodeMap.erase(node->key);
+            list->removeNode(node);
+            if(list->isEmpty())
+                unlinkFreqList(list);
+            decreaseFreqNum(decreaseNum); // 更新总频次
+        }
+
+        /**
+         * @brief 取得一个频率为 freq 的空链表（尚未挂入频率链）
+         * 优先复用回收池中的空链表（连同它的两个哨兵节点），回收池为空时才新建
+         */
+        FreqList<Key, Value>* acquireFreqList(size_t freq)
         {
-            if(!node) return;
-            int freq = node->freq;
-            // 如果这个频率的链表还没创建，先创建一个
-            if(_freqToFreqList.find(freq) == _freqToFreqList.end())
+            FreqList<Key, Value>* list;
+            if(!_spareLists.empty())
+            {
+                list = _spareLists.back();
+                _spareLists.pop_back();
+            }
+            else
             {
-                _freqToFreqList[freq] = std::make_shared<FreqList<Key, Value>>(freq);
+                _listPool.emplace_back(std::make_unique<FreqList<Key, Value>>(freq));
+                list = _listPool.back().get();
             }
-            _freqToFreqList[freq]->addNode(node);
+            list->_freq = freq;
+            return list;
+        }
+
+        /**
+         * @brief 将链表挂入频率链，位置在 prev 之后（prev 为空表示挂到链首）
+         */
+        void linkFreqList(FreqList<Key, Value>* list, FreqList<Key, Value>* prev)
+        {
+            FreqList<Key, Value>* next = prev ? prev->_nextList : _minFreqList;
+            list->_prevList = prev;
+            list->_nextList = next;
+            if(prev) prev->_nextList = list;
+            else _minFreqList = list;
+            if(next) next->_prevList = list;
+        }
+
+        /**
+         * @brief 将已空的链表从频率链上摘下，并放回回收池
+         */
+        void unlinkFreqList(FreqList<Key, Value>* list)
+        {
+            if(_anchor == list) _anchor = list->_prevList;
+            if(list->_prevList) list->_prevList->_nextList = list->_nextList;
+            else _minFreqList = list->_nextList;
+            if(list->_nextList) list->_nextList->_prevList = list->_prevList;
+            list->_prevList = list->_nextList = nullptr;
+            _spareLists.push_back(list);
         }
  
         /**
@@ -164,7 +324,7 @@ namespace myCache
         void addFreqNum()
         {
             _curTotalNum++;
-            _curAverageNum = _nodeMap.empty() ? 0 : _curTotalNum / _nodeMap.size();
+            _curAverageNum = _nodeMap.empty() ? 0 : _curTotalNum / static_cast<int>(_nodeMap.size());
             // 如果平均访问次数太高，触发平衡机制，防止频率无限增长
             if(_curAverageNum > _maxAverageNum)
                 handleOverMaxAverageNum();
@@ -173,104 +333,400 @@ namespace myCache
         void decreaseFreqNum(int num)
         {
             _curTotalNum -= num;
-            _curAverageNum = _nodeMap.empty() ? 0 : _curTotalNum / _nodeMap.size();
+            _curAverageNum = _nodeMap.empty() ? 0 : _curTotalNum / static_cast<int>(_nodeMap.size());
         }
  
         /**
-         * @brief 平衡机制：将所有节点的频率减半
-         * 防止某些数据早期访问极多，后期变冷门却因高频率无法被淘汰（缓存污染）
+         * @brief 平衡机制：所有节点的有效频率整体削减 maxAverageNum / 2
+         * 防止某些数据早期访问极多，后期变冷门却因高频率无法被淘汰（缓存污染）。
+         * 这里不再遍历全部节点重新挂链，而是推进一个全局衰减偏移（纪元），
+         * 节点在下次被访问时再与新纪元对齐，因此单次操作的耗时与缓存规模无关。
+         * 频率链的相对顺序在整体平移下保持不变，只需把锚点向后推进：
+         * 跨过的链表频率都落在 (旧偏移 + 1, 新偏移 + 1] 内，最多 maxAverageNum / 2 个。
          */
         void handleOverMaxAverageNum()
         {
             if(_nodeMap.empty()) return;
-            int cnt = 0;
-            for(auto it = _nodeMap.begin(); it != _nodeMap.end(); )
+            size_t decay = static_cast<size_t>(_maxAverageNum / 2);
+            if(decay == 0) return;
+
+            _freqOffset += decay;
+            FreqList<Key, Value>* next = _anchor ? _anchor->_nextList : _minFreqList;
+            while(next && next->_freq <= _freqOffset + 1)
             {
-                if(!it->second) { it = _nodeMap.erase(it); continue; }
-                
-                ++cnt;
-                NodePtr node = it->second;
-                removeFromFreqList(node);
-                node->freq -= _maxAverageNum / 2; // 频率整体削减
-                if(node->freq < 1) node->freq = 1;
-                addToFreqList(node);
-                ++it;
+                _anchor = next;
+                next = next->_nextList;
             }
-            _curTotalNum -= (_maxAverageNum / 2) * cnt;
+
+            int cnt = static_cast<int>(_nodeMap.size());
+            _curTotalNum -= static_cast<int>(decay) * cnt;
             _curAverageNum = _curTotalNum / cnt;
-            updateMinFreq(); // 重新寻找当前全局最小频率
         }
  
-        void updateMinFreq()
+    public:
+        /**
+         * @param capacity 缓存容量上限（所有条目权重之和的上限）
+         * @param maxAverageNum 触发频率老化的平均频次阈值
+         * @param weigher 权重函数，默认每个条目计 1
+         * @param bufferedReads 是否开启读缓冲：命中只记录访问，升频攒批进行
+         */
+        LFUCache(size_t capacity, int maxAverageNum = 10, Weigher weigher = Weigher(), bool bufferedReads = false)
+            : _capacity(capacity), _usedWeight(0), _weigher(weigher), _maxAverageNum(maxAverageNum),
+              _curAverageNum(0), _curTotalNum(0), _freqOffset(0),
+              _minFreqList(nullptr), _anchor(nullptr), _mutex(bufferedReads),
+              _readBuffer(bufferedReads ? std::make_unique<ReadBuffer<Node>>() : nullptr)
+        {}
+ 
+        ~LFUCache() override = default;
+ 
+        void put(const Key& key, const Value& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), value);
+        }
+ 
+        void put(const Key& key, Value&& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), std::move(value));
+        }
+ 
+        bool get(const Key& key, Value &value) override
+        {
+            return getImpl(key, value);
+        }
+ 
+        Value get(const Key& key) override
         {
-            _minFreq = INT_MAX;
-            for(const auto &pair : _freqToFreqList)
+            Value value{};
+            get(key, value);
+            return value;
+        }
+ 
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template <class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value &value)
+        {
+            return getImpl(key, value);
+        }
+ 
+        template <class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            getImpl(key, value);
+            return value;
+        }
+ 
+        /**
+         * @brief 免拷贝读取：命中时在锁内以 const 引用调用 fn(value)
+         * 对缓存的影响与 get 相同（节点升频）。fn 中不能再访问本缓存，否则会死锁；
+         * 开启读缓冲时 fn 在共享锁内执行，可能与其他读线程的 fn 并发。
+         * key 可以是 Key 或其异构查找类型。
+         * @return 是否命中
+         */
+        template <class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            return readImpl(key, _nodeMap.hashOf(key), std::forward<Fn>(fn));
+        }
+ 
+        /**
+         * @brief 带预先算好哈希的读写接口，供分片路由复用同一个哈希值
+         * hash 必须等于 cacheHashOf<Key>(key)，否则查找结果未定义
+         */
+        template <class K>
+        bool getWithHash(const K& key, uint64_t hash, Value &value)
+        {
+            return readImpl(key, hash, [&value](const Value& stored) { value = stored; });
+        }
+ 
+        template <class K, class Fn>
+        bool visitWithHash(const K& key, uint64_t hash, Fn&& fn)
+        {
+            return readImpl(key, hash, std::forward<Fn>(fn));
+        }
+ 
+        void putWithHash(const Key& key, uint64_t hash, const Value& value)
+        {
+            putImpl(key, hash, value);
+        }
+ 
+        void putWithHash(const Key& key, uint64_t hash, Value&& value)
+        {
+            putImpl(key, hash, std::move(value));
+        }
+ 
+        /**
+         * @brief 批量读取：先算好全部哈希，整批只加一次锁，探测时提前预取后面 Key 的索引组
+         * @param values 输出数组，长度不小于 count；命中的位置写入值，未命中的位置保持不变
+         * @param found 输出数组（可为空），记录每个位置是否命中
+         * @return 命中个数
+         */
+        size_t multiGet(const Key* keys, size_t count, Value* values, bool* found = nullptr)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = _nodeMap.hashOf(keys[i]);
+            if(found) std::fill(found, found + count, false);
+            return visitBatchWithHash(keys, hashes.data(), nullptr, count, [values, found](size_t i, const Value& stored)
             {
-                if(pair.second && !pair.second->isEmpty())
-                    _minFreq = std::min(_minFreq, pair.first);
-            }
-            if(_minFreq == INT_MAX) _minFreq = 1;
+                values[i] = stored;
+                if(found) found[i] = true;
+            });
         }
  
-    public:
-        LFUCache(int capacity, int maxAverageNum = 10)
-            : _capacity(capacity), _minFreq(INT_MAX),
-              _maxAverageNum(maxAverageNum), _curAverageNum(0), _curTotalNum(0)
-        {}
+        /**
+         * @brief 批量写入：哈希与权重在锁外算好，整批只加一次锁
+         */
+        void multiPut(const std::pair<Key, Value>* entries, size_t count)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = _nodeMap.hashOf(entries[i].first);
+            putBatchWithHash(entries, hashes.data(), nullptr, count);
+        }
  
-        ~LFUCache() override = default;
+        /**
+         * @brief 批量读取的底层版本，供分片路由按分片分组后调用
+         * 依次处理 indices[0..count) 指向的 Key（indices 为空时处理 0..count-1），hashes 按原下标给出；
+         * 命中时以原下标调用 fn(index, const Value&)，对缓存的影响与逐个 get 相同
+         * @return 命中个数
+         */
+        template <class Fn>
+        size_t visitBatchWithHash(const Key* keys, const uint64_t* hashes, const uint32_t* indices, size_t count, Fn&& fn)
+        {
+            auto at = [indices](size_t n) -> size_t { return indices ? indices[n] : n; };
+            auto hashAt = [hashes, &at](size_t n) { return hashes[at(n)]; };
+            size_t hits = 0;
+            if(!_readBuffer)
+            {
+                std::unique_lock<CacheMutex> lock(_mutex);
+                for(size_t n = 0; n < count; ++n)
+                {
+                    _nodeMap.prefetchBatch(n, count, hashAt);
+                    size_t i = at(n);
+                    auto it = _nodeMap.find(keys[i], hashes[i]);
+                    if(it == _nodeMap.end()) continue;
+                    getInternal(it->mapped);
+                    fn(i, static_cast<const Value&>(it->mapped->value));
+                    ++hits;
+                }
+                return hits;
+            }
+ 
+            bool shouldDrain = false;
+            {
+                std::shared_lock<CacheMutex> lock(_mutex);
+                for(size_t n = 0; n < count; ++n)
+                {
+                    _nodeMap.prefetchBatch(n, count, hashAt);
+                    size_t i = at(n);
+                    auto it = _nodeMap.find(keys[i], hashes[i]);
+                    if(it == _nodeMap.end()) continue;
+                    fn(i, static_cast<const Value&>(it->mapped->value));
+                    if(_readBuffer->record(it->mapped.get())) shouldDrain = true;
+                    ++hits;
+                }
+            }
+            if(shouldDrain) tryDrainReadBuffer();
+            return hits;
+        }
  
-        void put(Key key, Value value) override
+        /**
+         * @brief 批量写入的底层版本，下标约定与 visitBatchWithHash 相同
+         */
+        void putBatchWithHash(const std::pair<Key, Value>* entries, const uint64_t* hashes, const uint32_t* indices, size_t count)
         {
-            if(_capacity == 0) return;
-            std::lock_guard<std::mutex> lock(_mutex);
-            auto it = _nodeMap.find(key);
-            if(it != _nodeMap.end()) // 已存在，更新值并升频
+            auto at = [indices](size_t n) -> size_t { return indices ? indices[n] : n; };
+            auto hashAt = [hashes, &at](size_t n) { return hashes[at(n)]; };
+            std::vector<size_t> weights(count);
+            for(size_t n = 0; n < count; ++n) weights[n] = _weigher(entries[at(n)].first, entries[at(n)].second);
+ 
+            std::unique_lock<CacheMutex> lock(_mutex);
+            drainReadBuffer(); // 整批只回放一次
+            for(size_t n = 0; n < count; ++n)
             {
-                it->second->value = value;
-                getInternal(it->second, value);
-                return;
+                _nodeMap.prefetchBatch(n, count, hashAt);
+                size_t i = at(n);
+                putLocked(entries[i].first, hashes[i], entries[i].second, weights[n]);
             }
-            putInternal(key, value); // 不存在，新插
         }
  
-        bool get(Key key, Value &value) override
+        /**
+         * @brief 判断 Key 是否在缓存中（不影响访问频次）
+         */
+        template <class K>
+        bool contains(const K& key)
+        {
+            std::shared_lock<CacheMutex> lock(_mutex);
+            return _nodeMap.find(key) != _nodeMap.end();
+        }
+ 
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        template <class K>
+        void remove(const K& key)
         {
-            std::lock_guard<std::mutex> lock(_mutex);
+            std::unique_lock<CacheMutex> lock(_mutex);
+            drainReadBuffer(); // 先回放，保证缓冲中不会残留即将释放的节点
             auto it = _nodeMap.find(key);
             if(it != _nodeMap.end())
             {
-                getInternal(it->second, value);
-                return true;
+                eraseNode(it->mapped);
             }
-            return false;
         }
  
-        Value get(Key key) override
+        void purge()
         {
-            Value value{};
-            get(key, value);
-            return value;
+            std::unique_lock<CacheMutex> lock(_mutex);
+            drainReadBuffer();
+            _nodeMap.clear();
+            _spareLists.clear();
+            _listPool.clear(); // 智能指针会自动回收内存
+            _minFreqList = nullptr;
+            _anchor = nullptr;
+            _usedWeight = 0;
+        }
+
+        /**
+         * @brief 当前已占用的权重总和
+         */
+        size_t usedWeight()
+        {
+            std::shared_lock<CacheMutex> lock(_mutex);
+            return _usedWeight;
+        }
+
+        /**
+         * @brief 当前容量（权重预算）
+         */
+        size_t capacity()
+        {
+            std::shared_lock<CacheMutex> lock(_mutex);
+            return _capacity;
+        }
+
+        /**
+         * @brief 调整容量（权重预算），缩小时立即按 LFU 顺序淘汰直到回到预算之内
+         * 供分片缓存在分片之间挪动配额（见 CapacityBalancer）
+         */
+        void setCapacity(size_t capacity)
+        {
+            std::unique_lock<CacheMutex> lock(_mutex);
+            drainReadBuffer(); // 先回放，淘汰才能看到最新的频次，也不会释放缓冲中的节点
+            _capacity = capacity;
+            while(!_nodeMap.empty() && _usedWeight > _capacity)
+            {
+                kickOut(nullptr);
+            }
         }
  
-        void purge()
+    private:
+        /**
+         * @brief 读取逻辑：Key 与异构查找类型共用
+         */
+        template <class K>
+        bool getImpl(const K& key, Value &value)
         {
-            std::lock_guard<std::mutex> lock(_mutex);
-            _nodeMap.clear();
-            _freqToFreqList.clear(); // 智能指针会自动回收内存
+            return readImpl(key, _nodeMap.hashOf(key), [&value](const Value& stored) { value = stored; });
+        }
+
+        /**
+         * @brief 命中时以 const 引用调用 fn(value)，get 与 visit 共用
+         * 未开启读缓冲：独占锁内直接升频；开启读缓冲：共享锁内只查找并记录访问，条带满时再尝试回放。
+         * 哈希在加锁前算好，临界区内只做探测。
+         */
+        template <class K, class Fn>
+        bool readImpl(const K& key, uint64_t hash, Fn&& fn)
+        {
+            if(!_readBuffer)
+            {
+                std::unique_lock<CacheMutex> lock(_mutex);
+                auto it = _nodeMap.find(key, hash);
+                if(it == _nodeMap.end()) return false;
+                getInternal(it->mapped);
+                fn(static_cast<const Value&>(it->mapped->value));
+                return true;
+            }
+
+            bool shouldDrain;
+            {
+                std::shared_lock<CacheMutex> lock(_mutex);
+                auto it = _nodeMap.find(key, hash);
+                if(it == _nodeMap.end()) return false;
+                fn(static_cast<const Value&>(it->mapped->value));
+                shouldDrain = _readBuffer->record(it->mapped.get());
+            }
+            if(shouldDrain) tryDrainReadBuffer();
+            return true;
+        }
+ 
+        /**
+         * @brief 写入逻辑：两个 put 重载共用，value 按原本的值类别转发（左值拷贝、右值移动）
+         */
+        template <class V>
+        void putImpl(const Key& key, uint64_t hash, V&& value)
+        {
+            size_t weight = _weigher(key, value);
+            std::unique_lock<CacheMutex> lock(_mutex);
+            drainReadBuffer(); // 先回放积攒的访问，淘汰才能看到最新的频次，也不会释放缓冲中的节点
+            putLocked(key, hash, std::forward<V>(value), weight);
+        }
+
+        /**
+         * @brief 写入已算好权重的条目（调用方持有独占锁，且已回放读缓冲）
+         */
+        template <class V>
+        void putLocked(const Key& key, uint64_t hash, V&& value, size_t weight)
+        {
+            if(_capacity == 0) return; // 容量可能被 setCapacity 调整，只能在锁内判断
+            auto it = _nodeMap.find(key, hash);
+            if(weight > _capacity)
+            {
+                // 单个条目超过整个预算，无法存放：拒绝写入，同时丢弃旧值避免读到过期数据
+                if(it != _nodeMap.end()) eraseNode(it->mapped);
+                return;
+            }
+            if(it != _nodeMap.end()) // 已存在，更新值并升频
+            {
+                NodePtr node = it->mapped;
+                node->value = std::forward<V>(value);
+                _usedWeight = _usedWeight - node->weight + weight;
+                node->weight = weight;
+                getInternal(node);
+                while(_usedWeight > _capacity)
+                {
+                    kickOut(node); // 新值更重时淘汰其他节点，但不淘汰刚写入的节点
+                }
+                return;
+            }
+            putInternal(key, std::forward<V>(value), weight, hash); // 不存在，新插
         }
  
     private:
-        int _capacity;          // 缓存总容量
-        int _minFreq;           // 全局最小访问频率（淘汰时的搜索起点）
+        size_t _capacity;       // 缓存总容量（权重预算）
+        size_t _usedWeight;     // 当前已占用的权重
+        Weigher _weigher;       // 条目权重函数
         int _maxAverageNum;     // 触发频率缩减的阈值
         int _curAverageNum;     // 当前平均频率
         int _curTotalNum;       // 历史访问总次数（权重总和）
-        std::mutex _mutex;      // 线程安全锁
-        NodeMap _nodeMap;       // 快速定位：Key -> 节点
-        // 频率映射：频率 -> 该频率下的双向链表
-        std::unordered_map<int, std::shared_ptr<FreqList<Key, Value>>> _freqToFreqList;
+        size_t _freqOffset;     // 全局衰减偏移：每次老化累加 maxAverageNum / 2
+        FreqList<Key, Value>* _minFreqList; // 频率链首：存储频率最小的非空链表（淘汰时的起点）
+        FreqList<Key, Value>* _anchor;      // 锚点：存储频率 <= _freqOffset + 1 的最后一个非空链表
+        CacheMutex _mutex;      // 缓存锁：写操作独占；开启读缓冲时命中只取共享锁
+        NodeMap _nodeMap;       // 快速定位：Key -> 节点（标签分组索引）
+        // 频率链表池：持有所有创建过的链表；同时存在的链表数不超过节点数，因此池的规模有上限
+        std::vector<std::unique_ptr<FreqList<Key, Value>>> _listPool;
+        std::vector<FreqList<Key, Value>*> _spareLists; // 已从频率链摘下、可复用的空链表
+        std::unique_ptr<ReadBuffer<Node>> _readBuffer;  // 读缓冲，未开启时为空
     };
+
+    /**
+     * @brief 共享值模式的 LFU 缓存
+     * 节点中存放 SharedValue<Value>，get 在锁内只拷贝句柄，大对象的读取发生在锁外。
+     */
+    template <class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedLFUCache = LFUCache<Key, SharedValue<Value>, Weigher>;
 }
  
 #endif
@@ -0,0 +1,394 @@
+// ClockCache.hpp
+
+#ifndef __CLOCK_CACHE_HPP__
+#define __CLOCK_CACHE_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../Common/CachePolicy.hpp"
+#include "../Common/CacheHash.hpp"
+#include "../Common/CacheWeigher.hpp"
+#include "../Common/ConcurrentIndex.hpp"
+#include "../Common/EpochReclaimer.hpp"
+#include "../Common/SharedValue.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief CLOCK（二次机会）缓存：读多写少场景下对 LRU 的近似
+     * 与 LRUCache 的区别：命中时不再调整链表，只把条目的引用位原子地置 1，读操作不取任何锁：
+     * - 读（get / visit / contains）：在 EpochGuard 保护下遍历 ConcurrentIndex，读者只在回收域的槽位上登记纪元；
+     * - 写（put / remove 以及淘汰）：由一把互斥锁串行化。条目发布后除引用位外不再修改，更新时整条替换，
+     *   被替换或淘汰的旧条目交给 EpochDomain，等所有可能看到它的读者离开后再释放。
+     * 条目指针存放在一个环形槽位数组中（只由写者访问），淘汰时“指针”沿环扫描：引用位为 1 的清零后跳过（给第二次机会），
+     * 遇到引用位为 0 的即淘汰。新条目的引用位为 0，只被写入、从未被读过的条目会最先被淘汰。
+     * 容量同样按 Weigher 计算的权重累计。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class ClockCache : public CachePolicy<Key, Value>
+    {
+        typedef uint32_t Index;
+
+        /**
+         * @brief 缓存条目：发布后除引用位外不再修改
+         */
+        struct Entry : ConcurrentIndexHook<Entry>
+        {
+            const Key _key;
+            const Value _value;
+            size_t _weight;
+            Index _slot;                    // 在环上的槽位（只由写者访问）
+            std::atomic<bool> _referenced;  // 引用位：自上次被指针扫过之后是否被访问过
+
+            template<class V>
+            Entry(const Key& key, V&& value, size_t weight)
+                : _key(key), _value(std::forward<V>(value)), _weight(weight), _slot(0), _referenced(false)
+            {}
+        };
+
+        struct EntryKeyOf
+        {
+            const Key& operator()(const Entry& entry) const { return entry._key; }
+        };
+        typedef ConcurrentIndex<Key, Entry, EntryKeyOf> NodeMap;
+
+    private:
+        /**
+         * @brief 标记访问：引用位已经是 1 时不再写入，避免多个读线程反复写同一缓存行
+         */
+        static void touch(Entry* entry)
+        {
+            if(!entry->_referenced.load(std::memory_order_relaxed))
+            {
+                entry->_referenced.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief 转动指针淘汰一个条目（调用方持有写锁，且缓存非空）
+         * 最多转两圈：第一圈清掉所有引用位，第二圈必然遇到可淘汰的槽位
+         * @param keep 不允许淘汰的槽位（刚更新的条目），传环长度表示没有
+         */
+        void evictOne(Index keep)
+        {
+            while(true)
+            {
+                Index idx = _hand;
+                _hand = (_hand + 1) % static_cast<Index>(_ring.size());
+                Entry* entry = _ring[idx];
+                if(!entry || idx == keep) continue;
+                if(entry->_referenced.load(std::memory_order_relaxed))
+                {
+                    entry->_referenced.store(false, std::memory_order_relaxed); // 第二次机会
+                    continue;
+                }
+                eraseEntry(entry);
+                return;
+            }
+        }
+
+        /**
+         * @brief 获取一个空闲槽位，没有时在环尾追加
+         */
+        Index acquireSlot()
+        {
+            if(_freeSlots.empty())
+            {
+                _ring.push_back(nullptr);
+                return static_cast<Index>(_ring.size() - 1);
+            }
+            Index idx = _freeSlots.back();
+            _freeSlots.pop_back();
+            return idx;
+        }
+
+        /**
+         * @brief 从索引和环上摘下条目并退休（调用方持有写锁）
+         */
+        void eraseEntry(Entry* entry)
+        {
+            _nodeMap.erase(entry);
+            _ring[entry->_slot] = nullptr;
+            _freeSlots.push_back(entry->_slot);
+            _usedWeight -= entry->_weight;
+            _domain.retire(entry);
+        }
+
+    public:
+        /**
+         * @brief 初始化缓存
+         * @param capacity 缓存容量上限（所有条目权重之和的上限）
+         * @param weigher 权重函数，默认每个条目计 1
+         */
+        ClockCache(size_t capacity, Weigher weigher = Weigher())
+            : _capacity(capacity),
+              _usedWeight(0),
+              _weigher(weigher),
+              _hand(0),
+              _nodeMap(_domain, std::is_same<Weigher, UnitWeigher<Key, Value>>::value ? capacity : 0)
+        {}
+
+        /**
+         * @brief 析构时已没有读者：释放仍在缓存中的条目，已退休的条目由 _domain 释放
+         */
+        ~ClockCache() override
+        {
+            for(Entry* entry : _ring) delete entry;
+        }
+
+        void put(const Key& key, const Value& value) override
+        {
+            putImpl(key, value);
+        }
+
+        void put(const Key& key, Value&& value) override
+        {
+            putImpl(key, std::move(value));
+        }
+
+        /**
+         * @brief 读取数据：无锁查找 + 原子置引用位，不修改任何结构
+         */
+        bool get(const Key& key, Value& value) override
+        {
+            return getImpl(key, value);
+        }
+
+        Value get(const Key& key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            return getImpl(key, value);
+        }
+
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            getImpl(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：命中时以 const 引用调用 fn(value)
+         * 对缓存的影响与 get 相同（置引用位）。不持有任何锁，fn 可以与其他读线程的 fn 以及写操作并发执行：
+         * fn 看到的是查找时刻的值，即使条目随后被更新或淘汰，它也会保留到 fn 返回之后才释放。
+         * fn 中不应长时间停留，否则会推迟回收。
+         * @return 是否命中
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            EpochGuard guard(_domain);
+            Entry* entry = _nodeMap.find(key);
+            if(!entry) return false;
+            touch(entry);
+            fn(entry->_value);
+            return true;
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不置引用位）
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            EpochGuard guard(_domain);
+            return _nodeMap.find(key) != nullptr;
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        template<class K>
+        void remove(const K& key)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            removeLocked(key);
+        }
+
+        /**
+         * @brief 批量读取：整批只进入一次读临界区，不取任何锁，命中同样只置引用位
+         * @param values 输出数组，长度不小于 count；命中的位置写入值，未命中的位置保持不变
+         * @param found 输出数组（可为空），记录每个位置是否命中
+         * @return 命中个数
+         */
+        size_t multiGet(const Key* keys, size_t count, Value* values, bool* found = nullptr)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = _nodeMap.hashOf(keys[i]);
+            return getBatchWithHash(keys, hashes.data(), nullptr, count, values, found);
+        }
+
+        /**
+         * @brief 批量写入：权重与新条目在锁外准备好，整批只加一次写锁
+         */
+        void multiPut(const std::pair<Key, Value>* entries, size_t count)
+        {
+            putBatch(entries, nullptr, count);
+        }
+
+        /**
+         * @brief 批量读取的底层版本，供分片路由按分片分组后调用
+         * 依次处理 indices[0..count) 指向的 Key（indices 为空时处理 0..count-1），hashes / values / found 按原下标给出
+         * @return 命中个数
+         */
+        size_t getBatchWithHash(const Key* keys, const uint64_t* hashes, const uint32_t* indices, size_t count,
+                                Value* values, bool* found)
+        {
+            EpochGuard guard(_domain);
+            size_t hits = 0;
+            for(size_t n = 0; n < count; ++n)
+            {
+                size_t i = indices ? indices[n] : n;
+                Entry* entry = _nodeMap.find(keys[i], hashes[i]);
+                if(found) found[i] = entry != nullptr;
+                if(!entry) continue;
+                touch(entry);
+                values[i] = entry->_value;
+                ++hits;
+            }
+            return hits;
+        }
+
+        /**
+         * @brief 批量写入的底层版本，下标约定与 getBatchWithHash 相同
+         */
+        void putBatch(const std::pair<Key, Value>* entries, const uint32_t* indices, size_t count)
+        {
+            if(_capacity == 0) return;
+            // 超出整个预算的条目留空，锁内只删除旧值
+            std::vector<Entry*> fresh(count);
+            for(size_t n = 0; n < count; ++n)
+            {
+                const std::pair<Key, Value>& kv = entries[indices ? indices[n] : n];
+                size_t weight = _weigher(kv.first, kv.second);
+                fresh[n] = weight > _capacity ? nullptr : new Entry(kv.first, kv.second, weight);
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            for(size_t n = 0; n < count; ++n)
+            {
+                if(fresh[n]) putLocked(fresh[n]);
+                else removeLocked(entries[indices ? indices[n] : n].first);
+            }
+        }
+
+        /**
+         * @brief 当前已占用的权重总和
+         */
+        size_t usedWeight()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _usedWeight;
+        }
+
+    private:
+        template<class K>
+        void removeLocked(const K& key)
+        {
+            Entry* entry = _nodeMap.find(key);
+            if(entry) eraseEntry(entry);
+        }
+
+        /**
+         * @brief 读取逻辑：Key 与异构查找类型共用
+         */
+        template<class K>
+        bool getImpl(const K& key, Value& value)
+        {
+            EpochGuard guard(_domain);
+            Entry* entry = _nodeMap.find(key);
+            if(!entry) return false;
+            touch(entry);
+            value = entry->_value;
+            return true;
+        }
+
+        /**
+         * @brief 写入逻辑：两个 put 重载共用，value 按原本的值类别转发（左值拷贝、右值移动）
+         * 新条目在写锁外构造好，锁内只做索引替换与淘汰
+         */
+        template<class V>
+        void putImpl(const Key& key, V&& value)
+        {
+            if(_capacity == 0) return;
+            size_t weight = _weigher(key, value);
+            if(weight > _capacity)
+            {
+                // 单个条目超过整个预算，无法存放：拒绝写入，同时丢弃旧值避免读到过期数据
+                remove(key);
+                return;
+            }
+            Entry* entry = new Entry(key, std::forward<V>(value), weight);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            putLocked(entry);
+        }
+
+        /**
+         * @brief 发布一个已构造好的条目：替换同 Key 的旧条目或按需淘汰后插入（调用方持有写锁）
+         */
+        void putLocked(Entry* entry)
+        {
+            size_t weight = entry->_weight;
+            Entry* old = _nodeMap.find(entry->_key);
+            if(old)
+            {
+                // 新条目继承旧条目的槽位与访问状态，读者要么看到旧值要么看到新值
+                Index idx = old->_slot;
+                entry->_slot = idx;
+                entry->_referenced.store(true, std::memory_order_relaxed);
+                _ring[idx] = entry;
+                _nodeMap.replace(old, entry);
+                _usedWeight = _usedWeight - old->_weight + weight;
+                _domain.retire(old);
+                while(_usedWeight > _capacity)
+                {
+                    evictOne(idx); // 新值更重时淘汰其他条目，刚更新的条目不参与
+                }
+                return;
+            }
+            while(!_nodeMap.empty() && _usedWeight + weight > _capacity)
+            {
+                evictOne(static_cast<Index>(_ring.size()));
+            }
+            entry->_slot = acquireSlot();
+            _ring[entry->_slot] = entry;
+            _usedWeight += weight;
+            _nodeMap.insert(entry);
+        }
+
+    private:
+        size_t _capacity;               // 缓存最大容量（权重预算）
+        size_t _usedWeight;             // 当前已占用的权重
+        Weigher _weigher;               // 条目权重函数
+        EpochDomain _domain;            // 读者登记与延迟回收，须先于 _nodeMap 构造、晚于其析构
+        std::vector<Entry*> _ring;      // 环形槽位数组（只由写者访问）
+        std::vector<Index> _freeSlots;  // 空闲槽位下标
+        Index _hand;                    // 时钟指针：下一次淘汰从这里开始扫描
+        NodeMap _nodeMap;               // 读无锁的并发索引：Key -> 条目
+        alignas(CACHE_LINE_SIZE) std::mutex _mutex; // 写锁：put / remove / 淘汰串行执行；独占缓存行，加解锁不会使读者访问的字段失效
+    };
+
+    /**
+     * @brief 共享值模式的 CLOCK 缓存：读取时只拷贝句柄
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedClockCache = ClockCache<Key, SharedValue<Value>, Weigher>;
+}
+
+#endif
@@ -0,0 +1,58 @@
+// ConcurrentLRUCache.hpp
+
+#ifndef __CONCURRENT_LRU_CACHE_HPP__
+#define __CONCURRENT_LRU_CACHE_HPP__
+
+#include "LRU.hpp"
+#include "../Common/ConcurrentCache.hpp"
+#include "../Common/HashConcurrentCache.hpp"
+#include "../Common/SharedValue.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 读路径无锁的 LRU 缓存
+     * 查找走 ConcurrentIndex，不取任何锁；淘汰顺序仍由一个 LRUCache 决定，
+     * 命中记入读缓冲，攒批回放成对 LRUCache 的访问，链表调整推迟到回放时进行（见 ConcurrentCache）。
+     * 与 LRUCache 的区别：读者之间互不阻塞，代价是丢弃的访问记录会让 LRU 顺序略不精确。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class ConcurrentLRUCache : public ConcurrentCache<Key, Value, LRUCache, Weigher>
+    {
+    public:
+        /**
+         * @brief 初始化缓存
+         * @param capacity 缓存容量上限（所有条目权重之和的上限）
+         * @param weigher 权重函数，默认每个条目计 1
+         */
+        explicit ConcurrentLRUCache(size_t capacity, Weigher weigher = Weigher())
+            : ConcurrentCache<Key, Value, LRUCache, Weigher>(capacity, weigher)
+        {}
+    };
+
+    /**
+     * @brief 分片的读路径无锁 LRU 缓存：每个分片一把写锁、一个读缓冲
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class HashConcurrentLRUCache : public HashConcurrentCache<Key, Value, LRUCache, Weigher>
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 总缓存容量（所有条目权重之和的上限）
+         * @param sliceNum 分片数量，不大于 0 时取硬件并发核心数，向上取整为 2 的幂
+         * @param weigher 权重函数，默认每个条目计 1
+         */
+        HashConcurrentLRUCache(size_t capacity, int sliceNum, Weigher weigher = Weigher())
+            : HashConcurrentCache<Key, Value, LRUCache, Weigher>(capacity, sliceNum, weigher)
+        {}
+    };
+
+    /**
+     * @brief 共享值模式的并发缓存：读取时只拷贝句柄
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedConcurrentLRUCache = ConcurrentLRUCache<Key, SharedValue<Value>, Weigher>;
+}
+
+#endif
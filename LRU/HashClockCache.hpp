@@ -0,0 +1,179 @@
+// HashClockCache.hpp
+
+#ifndef __HASH_CLOCK_CACHE_HPP__
+#define __HASH_CLOCK_CACHE_HPP__
+
+#include "ClockCache.hpp"
+#include "../Common/ShardArray.hpp"
+#include <vector>
+#include <thread>
+#include <utility>
+
+namespace myCache
+{
+    /**
+     * @brief HashClockCache 模板类
+     * 与 HashLRUCache 相同的分片方式，每个分片是一个 ClockCache。
+     * 分片内部的读操作不取任何锁，分片只用来拆分写锁，降低写操作之间的竞争；读多写少时吞吐量随核心数增长。
+     * Weigher 会传递给每个分片，容量（权重预算）按分片均分。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class HashClockCache
+    {
+    private:
+        /**
+         * @brief 哈希定位函数：与分片内部索引相同的混淆哈希（cacheHashOf），取最高几位选择分片
+         */
+        template<class K>
+        uint64_t Hash(const K& key)
+        {
+            return cacheHashOf<Key>(key);
+        }
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 总缓存容量（所有条目权重之和的上限）
+         * @param sliceNum 分片数量，不大于 0 时取硬件并发核心数，向上取整为 2 的幂
+         * @param weigher 权重函数，默认每个条目计 1
+         */
+        HashClockCache(size_t capacity, int sliceNum, Weigher weigher = Weigher())
+            : _capacity(capacity),
+              _router(sliceNum),
+              // 容量向上取整均分到各分片，分片连续存放在按缓存行对齐的数组中
+              _clockSliceCaches(_router.shardCount(), _router.perShard(capacity), weigher)
+        {}
+
+        void put(const Key& key, const Value& value)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            _clockSliceCaches[sliceIndex].put(key, value);
+        }
+
+        void put(const Key& key, Value&& value)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            _clockSliceCaches[sliceIndex].put(key, std::move(value));
+        }
+
+        bool get(const Key& key, Value& value)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            return _clockSliceCaches[sliceIndex].get(key, value);
+        }
+
+        Value get(const Key& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            return _clockSliceCaches[sliceIndex].get(key, value);
+        }
+
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 批量读取：一次算好全部哈希，按分片分组，每个分片只进入一次读临界区（不取锁），哈希交给分片索引复用
+         * @param values 输出数组，长度不小于 count；命中的位置写入值，未命中的位置保持不变
+         * @param found 输出数组（可为空），记录每个位置是否命中
+         * @return 命中个数
+         */
+        size_t multiGet(const Key* keys, size_t count, Value* values, bool* found = nullptr)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = Hash(keys[i]);
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> offsets;
+            _router.group(hashes.data(), count, order, offsets);
+
+            size_t hits = 0;
+            for(size_t s = 0; s < _router.shardCount(); ++s)
+            {
+                size_t begin = offsets[s];
+                size_t n = offsets[s + 1] - begin;
+                if(n == 0) continue;
+                hits += _clockSliceCaches[s].getBatchWithHash(keys, hashes.data(), order.data() + begin, n, values, found);
+            }
+            return hits;
+        }
+
+        /**
+         * @brief 批量写入：一次算好全部哈希，按分片分组，每个分片只加一次写锁
+         */
+        void multiPut(const std::pair<Key, Value>* entries, size_t count)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = Hash(entries[i].first);
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> offsets;
+            _router.group(hashes.data(), count, order, offsets);
+
+            for(size_t s = 0; s < _router.shardCount(); ++s)
+            {
+                size_t begin = offsets[s];
+                size_t n = offsets[s + 1] - begin;
+                if(n == 0) continue;
+                _clockSliceCaches[s].putBatch(entries, order.data() + begin, n);
+            }
+        }
+
+        /**
+         * @brief 免拷贝读取：不取锁，命中时以 const 引用调用 fn(value)（fn 可能与写操作并发，见 ClockCache::visit）
+         * @return 是否命中
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            return _clockSliceCaches[sliceIndex].visit(key, std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不置引用位）
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            return _clockSliceCaches[sliceIndex].contains(key);
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        template<class K>
+        void remove(const K& key)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            _clockSliceCaches[sliceIndex].remove(key);
+        }
+
+    private:
+        size_t _capacity; // 总容量
+        ShardRouter _router; // 分片路由：分片数为 2 的幂
+        ShardArray<ClockCache<Key, Value, Weigher>> _clockSliceCaches;
+    };
+
+    /**
+     * @brief 共享值模式的分片 CLOCK 缓存
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedHashClockCache = HashClockCache<Key, SharedValue<Value>, Weigher>;
+}
+
+#endif
@@ -4,10 +4,11 @@
 #define __HASH_LRU_HPP__
  
 #include "LRU.hpp"
+#include "../Common/ShardArray.hpp"
+#include "../Common/CapacityBalancer.hpp"
 #include <vector>
-#include <cmath>
 #include <thread>
-#include <cstring>
+#include <utility>
  
 namespace myCache
 {
@@ -15,81 +16,228 @@ namespace myCache
      * @brief HashLRUCache 模板类
      * 核心思想：将一个大 LRU 拆分为多个小 LRU。
      * 作用：降低锁的粒度，允许多个线程同时访问不同的分片，从而提升高并发下的吞吐量。
+     * Weigher 会传递给每个分片，容量（权重预算）按分片均分；开启 adaptiveCapacity 后，
+     * 配额会按各分片的未命中压力在分片之间挪动（见 CapacityBalancer），Key 分布倾斜时命中率接近不分片的 LRU。
      */
-    template<class Key, class Value>
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
     class HashLRUCache
     {
     private:
         /**
          * @brief 哈希定位函数
-         * 根据 Key 计算其对应的哈希值，决定该数据存放在哪一个分片
+         * 根据 Key 计算其对应的哈希值，决定该数据存放在哪一个分片。
+         * 使用与分片内部索引完全相同的混淆哈希（cacheHashOf），异构查找类型会被路由到同一个分片；
+         * 算出的哈希值随请求一起交给分片，分片内部不再重复计算。
          */
-        size_t Hash(Key key)
+        template<class K>
+        uint64_t Hash(const K& key)
         {
-            std::hash<Key> hashFunc;
-            return hashFunc(key);
+            return cacheHashOf<Key>(key);
         }
 
     public:
         /**
          * @brief 构造函数
-         * @param capacity 总缓存容量
-         * @param sliceNum 分片数量（建议设置为 CPU 核心数的 1-2 倍）
+         * @param capacity 总缓存容量（所有条目权重之和的上限）
+         * @param sliceNum 分片数量（建议设置为 CPU 核心数的 1-2 倍），向上取整为 2 的幂
+         * @param weigher 权重函数，默认每个条目计 1
+         * @param bufferedReads 是否为每个分片开启读缓冲（见 LRUCache）
+         * @param adaptiveCapacity 是否按未命中压力在分片之间再分配容量，总容量保持不变
          */
-        HashLRUCache(size_t capacity, int sliceNum)
+        HashLRUCache(size_t capacity, int sliceNum, Weigher weigher = Weigher(), bool bufferedReads = false,
+                     bool adaptiveCapacity = false)
             : _capacity(capacity),
-              // 如果未指定分片数，默认设置为当前系统的硬件并发核心数
-              _sliceNum(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())
-        {
-            // 计算每个分片应分配的容量（向上取整，确保总容量不低于设定值）
-            size_t sliceSize = std::ceil(capacity / static_cast<double>(_sliceNum));
-            
-            // 初始化分片容器，并为每个分片创建一个独立的 LRUCache
-            for(int i = 0; i < _sliceNum; i++)
-            {
-                _LRUSliceCaches.emplace_back(std::make_unique<LRUCache<Key, Value>>(sliceSize));
-            }
-        }
+              // 如果未指定分片数，默认按当前系统的硬件并发核心数；分片数向上取整为 2 的幂，路由只需移位
+              _router(sliceNum),
+              // 每个分片分到的容量向上取整，确保总容量不低于设定值；分片连续存放在按缓存行对齐的数组中
+              _LRUSliceCaches(_router.shardCount(), _router.perShard(capacity), weigher, bufferedReads),
+              // 只有一个分片时没有可以挪动的对象
+              _balancer(adaptiveCapacity && _router.shardCount() > 1
+                        ? std::make_unique<CapacityBalancer>(_router.shardCount(), _router.perShard(capacity))
+                        : nullptr)
+        {}
  
         /**
          * @brief 存入数据
          * 先计算哈希值找到对应的分片，然后在该分片内部进行 put 操作（内部带锁）
          */
-        void put(Key key, Value value)
+        void put(const Key& key, const Value& value)
+        {
+            uint64_t hash = Hash(key);
+            _LRUSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, value);
+        }
+ 
+        /**
+         * @brief 存入数据（右值版本），值一路移动到分片的节点中
+         */
+        void put(const Key& key, Value&& value)
         {
-            size_t sliceIndex = Hash(key) % _sliceNum;
-            _LRUSliceCaches[sliceIndex]->put(key, value);
+            uint64_t hash = Hash(key);
+            _LRUSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, std::move(value));
         }
  
         /**
          * @brief 获取数据（引用传参方式）
          * @return 是否命中缓存
          */
-        bool get(Key key, Value& value)
+        bool get(const Key& key, Value& value)
         {
-            size_t sliceIndex = Hash(key) % _sliceNum;
-            return _LRUSliceCaches[sliceIndex]->get(key, value);
+            uint64_t hash = Hash(key);
+            size_t sliceIndex = _router.shardOf(hash);
+            if(_LRUSliceCaches[sliceIndex].getWithHash(key, hash, value)) return true;
+            recordMiss(sliceIndex, hash);
+            return false;
         }
         
         /**
          * @brief 获取数据（直接返回方式）
-         * 若未命中，返回一个内存清零的默认对象
+         * 若未命中，返回值初始化的默认对象
+         * （原先用 memset 清零，对 std::string 等非平凡类型会破坏对象，这里改为值初始化）
+         */
+        Value get(const Key& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+ 
+        /**
+         * @brief 免拷贝读取：在对应分片的锁内以 const 引用调用 fn(value)
+         * @return 是否命中
          */
-        Value get(Key key)
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
         {
-            Value value;
-            // 初始清零处理，防止返回包含随机垃圾数据的对象
-            memset(&value, 0, sizeof(Value));
+            uint64_t hash = Hash(key);
+            size_t sliceIndex = _router.shardOf(hash);
+            if(_LRUSliceCaches[sliceIndex].visitWithHash(key, hash, std::forward<Fn>(fn))) return true;
+            recordMiss(sliceIndex, hash);
+            return false;
+        }
+ 
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            uint64_t hash = Hash(key);
+            size_t sliceIndex = _router.shardOf(hash);
+            if(_LRUSliceCaches[sliceIndex].getWithHash(key, hash, value)) return true;
+            recordMiss(sliceIndex, hash);
+            return false;
+        }
+ 
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
             get(key, value);
             return value;
         }
  
+        /**
+         * @brief 批量读取：一次算好全部哈希，按分片分组，每个分片只加一次锁（组内提前预取索引）
+         * @param values 输出数组，长度不小于 count；命中的位置写入值，未命中的位置保持不变
+         * @param found 输出数组（可为空），记录每个位置是否命中
+         * @return 命中个数
+         */
+        size_t multiGet(const Key* keys, size_t count, Value* values, bool* found = nullptr)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = Hash(keys[i]);
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> offsets;
+            _router.group(hashes.data(), count, order, offsets);
+ 
+            std::vector<char> hit(count, 0);
+            size_t hits = 0;
+            for(size_t s = 0; s < _router.shardCount(); ++s)
+            {
+                size_t begin = offsets[s];
+                size_t n = offsets[s + 1] - begin;
+                if(n == 0) continue;
+                hits += _LRUSliceCaches[s].visitBatchWithHash(keys, hashes.data(), order.data() + begin, n,
+                    [values, &hit](size_t i, const Value& stored)
+                    {
+                        values[i] = stored;
+                        hit[i] = 1;
+                    });
+            }
+            // 所有分片锁都已释放，再统一记录未命中（可能触发容量再分配）
+            for(size_t i = 0; i < count; ++i)
+            {
+                if(found) found[i] = hit[i] != 0;
+                if(!hit[i]) recordMiss(_router.shardOf(hashes[i]), hashes[i]);
+            }
+            return hits;
+        }
+ 
+        /**
+         * @brief 批量写入：一次算好全部哈希，按分片分组，每个分片只加一次锁
+         */
+        void multiPut(const std::pair<Key, Value>* entries, size_t count)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = Hash(entries[i].first);
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> offsets;
+            _router.group(hashes.data(), count, order, offsets);
+ 
+            for(size_t s = 0; s < _router.shardCount(); ++s)
+            {
+                size_t begin = offsets[s];
+                size_t n = offsets[s + 1] - begin;
+                if(n == 0) continue;
+                _LRUSliceCaches[s].putBatchWithHash(entries, hashes.data(), order.data() + begin, n);
+            }
+        }
+ 
+        /**
+         * @brief 判断 Key 是否在缓存中（不影响访问顺序）
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            return _LRUSliceCaches[sliceIndex].contains(key);
+        }
+ 
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        template<class K>
+        void remove(const K& key)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            _LRUSliceCaches[sliceIndex].remove(key);
+        }
+ 
+    private:
+        /**
+         * @brief 未命中时记录分片压力，到达间隔时在当前线程内再分配容量（此时不持有任何分片锁）
+         */
+        void recordMiss(size_t sliceIndex, uint64_t hash)
+        {
+            if(_balancer && _balancer->recordMiss(sliceIndex, hash))
+            {
+                _balancer->rebalance([this](size_t i, size_t capacity) { _LRUSliceCaches[i].setCapacity(capacity); });
+            }
+        }
+
     private:
         size_t _capacity; // 总容量
-        int _sliceNum;    // 分片（切片）数量
-        // 使用智能指针存储每个分片的 LRU 实例，防止内存泄漏并支持动态初始化
-        std::vector<std::unique_ptr<LRUCache<Key, Value>>> _LRUSliceCaches; 
+        ShardRouter _router; // 分片路由：分片数为 2 的幂
+        // 所有分片连续存放，每个分片独占整数个缓存行，相邻分片之间没有伪共享
+        ShardArray<LRUCache<Key, Value, Weigher>> _LRUSliceCaches;
+        std::unique_ptr<CapacityBalancer> _balancer; // 容量再分配，未开启时为空
     };
+ 
+    /**
+     * @brief 共享值模式的分片 LRU：分片锁内只拷贝句柄
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedHashLRUCache = HashLRUCache<Key, SharedValue<Value>, Weigher>;
 }
  
 #endif
\ No newline at end of file
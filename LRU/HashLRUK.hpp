@@ -0,0 +1,162 @@
+// HashLRUK.hpp
+
+#ifndef __HASH_LRUK_HPP__
+#define __HASH_LRUK_HPP__
+
+#include "LRUK.hpp"
+#include "../Common/ShardArray.hpp"
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <utility>
+
+namespace myCache
+{
+    /**
+     * @brief HashLRUKCache 模板类
+     * 与 HashLRUCache 相同的分片方式，每个分片是一个完整的 LRUKCache（一把锁同时保护主缓存与历史队列）。
+     * 主缓存容量与历史队列容量都按分片均分，Weigher 会传递给每个分片的主缓存。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class HashLRUKCache
+    {
+    private:
+        /**
+         * @brief 哈希定位函数：与分片内部索引相同的混淆哈希（cacheHashOf），取最高几位选择分片，
+         * 同一个哈希值随后交给分片的带哈希接口，主缓存与历史队列的索引都不再重新计算
+         */
+        uint64_t Hash(const Key& key)
+        {
+            return cacheHashOf<Key>(key);
+        }
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 主缓存（热点队列）总容量
+         * @param sliceNum 分片数量，不大于 0 时取硬件并发核心数，向上取整为 2 的幂
+         * @param historyCapacity 历史队列总容量
+         * @param k 晋升阈值：访问达到 k 次的数据会被移入主缓存
+         * @param weigher 主缓存的权重函数
+         */
+        HashLRUKCache(size_t capacity, int sliceNum, int historyCapacity, int k, Weigher weigher = Weigher())
+            : _capacity(capacity),
+              _router(sliceNum),
+              // 容量向上取整均分到各分片，分片连续存放在按缓存行对齐的数组中
+              _lrukSliceCaches(_router.shardCount(), _router.perShard(capacity),
+                               static_cast<int>(_router.perShard(historyCapacity > 0 ? historyCapacity : 0)), k, weigher)
+        {}
+
+        void put(const Key& key, const Value& value)
+        {
+            uint64_t hash = Hash(key);
+            _lrukSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, value);
+        }
+
+        void put(const Key& key, Value&& value)
+        {
+            uint64_t hash = Hash(key);
+            _lrukSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, std::move(value));
+        }
+
+        bool get(const Key& key, Value& value)
+        {
+            uint64_t hash = Hash(key);
+            return _lrukSliceCaches[_router.shardOf(hash)].getWithHash(key, hash, value);
+        }
+
+        Value get(const Key& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：在对应分片的锁内以 const 引用调用 fn(value)，与 get 一样计入历史
+         * @return 是否命中
+         */
+        template<class Fn>
+        bool visit(const Key& key, Fn&& fn)
+        {
+            uint64_t hash = Hash(key);
+            return _lrukSliceCaches[_router.shardOf(hash)].visitWithHash(key, hash, std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 批量读取：一次算好全部哈希，按分片分组，每个分片只加一次锁
+         * @param values 输出数组，长度不小于 count；命中的位置写入值，未命中的位置保持不变
+         * @param found 输出数组（可为空），记录每个位置是否命中
+         * @return 命中个数
+         */
+        size_t multiGet(const Key* keys, size_t count, Value* values, bool* found = nullptr)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = Hash(keys[i]);
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> offsets;
+            _router.group(hashes.data(), count, order, offsets);
+            if(found) std::fill(found, found + count, false);
+
+            size_t hits = 0;
+            for(size_t s = 0; s < _router.shardCount(); ++s)
+            {
+                size_t begin = offsets[s];
+                size_t n = offsets[s + 1] - begin;
+                if(n == 0) continue;
+                hits += _lrukSliceCaches[s].visitBatchWithHash(keys, hashes.data(), order.data() + begin, n,
+                    [values, found](size_t i, const Value& stored)
+                    {
+                        values[i] = stored;
+                        if(found) found[i] = true;
+                    });
+            }
+            return hits;
+        }
+
+        /**
+         * @brief 批量写入：一次算好全部哈希，按分片分组，每个分片只加一次锁
+         */
+        void multiPut(const std::pair<Key, Value>* entries, size_t count)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = Hash(entries[i].first);
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> offsets;
+            _router.group(hashes.data(), count, order, offsets);
+
+            for(size_t s = 0; s < _router.shardCount(); ++s)
+            {
+                size_t begin = offsets[s];
+                size_t n = offsets[s + 1] - begin;
+                if(n == 0) continue;
+                _lrukSliceCaches[s].putBatchWithHash(entries, hashes.data(), order.data() + begin, n);
+            }
+        }
+
+        /**
+         * @brief 判断 Key 是否在主缓存中（不影响访问顺序与历史计数）
+         */
+        bool contains(const Key& key)
+        {
+            uint64_t hash = Hash(key);
+            return _lrukSliceCaches[_router.shardOf(hash)].containsWithHash(key, hash);
+        }
+
+        /**
+         * @brief 手动删除指定 Key（主缓存条目与历史记录一并清除）
+         */
+        void remove(const Key& key)
+        {
+            uint64_t hash = Hash(key);
+            _lrukSliceCaches[_router.shardOf(hash)].removeWithHash(key, hash);
+        }
+
+    private:
+        size_t _capacity; // 主缓存总容量
+        ShardRouter _router; // 分片路由：分片数为 2 的幂
+        ShardArray<LRUKCache<Key, Value, Weigher>> _lrukSliceCaches;
+    };
+}
+
+#endif
@@ -1,15 +1,22 @@
 #ifndef __LRU_HPP__
 #define __LRU_HPP__
 
+#include <algorithm>
 #include <memory>
-#include <unordered_map>   
+#include <utility>
 #include <mutex>
+#include <vector>
 #include "../Common/CachePolicy.hpp"
+#include "../Common/CacheHash.hpp"
+#include "../Common/CacheWeigher.hpp"
+#include "../Common/TagIndex.hpp"
+#include "../Common/ReadBuffer.hpp"
+#include "../Common/SharedValue.hpp"
 
 namespace myCache
 {
     // 前向声明，方便 LRUNode 声明友元
-    template<class Key, class Value> class LRUCache;
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>> class LRUCache;
     /**
      * @brief LRU双向链表节点
      */
@@ -17,18 +24,21 @@ namespace myCache
     class LRUNode
     {
         typedef LRUNode<Key,Value> Node;
-        friend class LRUCache<Key, Value>; // 允许 LRUCache 访问私有成员
+        template<class K, class V, class W>
+        friend class LRUCache; // 允许 LRUCache 访问私有成员
     private:
         Key _key;
         Value _value;
         size_t _accessCount;        // 统计该节点的访问次数
+        size_t _weight;             // 该节点计入容量的权重（由 Weigher 计算）
         std::weak_ptr<Node> _prev;  // 指向前驱节点，使用 weak_ptr 防止与 next 形成循环引用导致内存泄漏
         std::shared_ptr<Node> _next;// 指向后继节点
     public:
-        LRUNode(Key key, Value value): _key(key), _value(value), _accessCount(1){}
-        Key getKey() const { return _key; }
-        Value getValue() const { return _value; }
+        LRUNode(Key key, Value value): _key(std::move(key)), _value(std::move(value)), _accessCount(1), _weight(0){}
+        const Key& getKey() const { return _key; }
+        const Value& getValue() const { return _value; }
         void setValue(const Value& value) { _value = value; }
+        void setValue(Value&& value) { _value = std::move(value); }
         size_t getAccessCount() const { return _accessCount; }
         void incrementAccessCount() { _accessCount++; }
     };
@@ -36,35 +46,63 @@ namespace myCache
     /**
      * @brief 基于双向链表和哈希表的 LRU 缓存实现
      * 逻辑：最近访问的放在尾部(tail)，最久未访问的放在头部(head)
+     * 容量按 Weigher 计算的权重累计：默认每个条目权重为 1（即条目数上限），
+     * 换成 ByteWeigher 等函数后容量即为字节预算。
+     * 开启读缓冲（bufferedReads）后，命中只在共享锁下查找并把节点记入 ReadBuffer，
+     * 链表调整攒批后在独占锁下统一回放，读者之间不再等待彼此的链表修改。
+     * 共享锁的加解锁仍是对同一个锁字的原子读-改-写，核心多时读者依旧在这一缓存行上排队；
+     * 需要读路径完全不取锁时使用 ConcurrentLRUCache。
      */
-    template<class Key, class Value>
+    template<class Key, class Value, class Weigher>
     class LRUCache : public CachePolicy<Key, Value>
     {
+        template<class K, class V, class W>
+        friend class LRUKCache; // LRUKCache 以本类为主缓存，在同一把锁内组合主缓存与历史队列的操作
+        template<class K, class V, template<class, class, class> class P, class W>
+        friend class ConcurrentCache; // ConcurrentCache 在自己的写锁内直接调用下面的不加锁接口
+
         typedef LRUNode<Key, Value> Node;
         typedef std::shared_ptr<Node> NodePtr;
-        typedef std::unordered_map<Key, NodePtr> NodeMap;
+
+        // 索引中只存节点指针，Key 直接从节点中取
+        struct NodeKeyOf
+        {
+            const Key& operator()(const NodePtr& node) const { return node->getKey(); }
+        };
+        typedef TagIndex<Key, NodePtr, NodeKeyOf> NodeMap;
 
     private:
         /**
          * @brief 更新已存在的节点：修改值并移动到链表末尾
          */
-        void updateExistringNode(NodePtr node, const Value& value)
+        template<class V>
+        void updateExistringNode(NodePtr node, V&& value, size_t weight)
         {
-            node->setValue(value);
+            node->setValue(std::forward<V>(value));
+            _usedWeight = _usedWeight - node->_weight + weight;
+            node->_weight = weight;
             moveToMostRecent(node);
+            // 新值更重时，从最久未使用的一端淘汰直至满足预算（该节点已在尾部，不会被自己淘汰）
+            while(_usedWeight > _capacity)
+            {
+                evictLeastRecent();
+            }
         }
 
         /**
          * @brief 添加新节点：处理容量检查并插入到末尾
          */
-        void addNewNode(const Key& key, const Value& value)
+        template<class V>
+        void addNewNode(const Key& key, V&& value, size_t weight, uint64_t hash)
         {
-            if(_nodeMap.size() >= _capacity)
+            while(!_nodeMap.empty() && _usedWeight + weight > _capacity)
             {
-                evictLeastRecent(); // 缓存满，驱逐最久未使用的节点
+                evictLeastRecent(); // 缓存满，驱逐最久未使用的节点，直到能容纳新节点
             }
-            NodePtr newNode = std::make_shared<Node>(key, value);
-            _nodeMap[key] = newNode;
+            NodePtr newNode = std::make_shared<Node>(key, std::forward<V>(value));
+            newNode->_weight = weight;
+            _usedWeight += weight;
+            _nodeMap.insert(newNode, hash);
             insertNode(newNode);
         }
 
@@ -101,6 +139,7 @@ namespace myCache
         {
             NodePtr leastRecent = _head->_next; // head 之后第一个是真正的数据节点
             removeNode(leastRecent);
+            _usedWeight -= leastRecent->_weight;
             _nodeMap.erase(leastRecent->getKey()); // 处理map
         }
         
@@ -115,13 +154,42 @@ namespace myCache
             _tail->_prev = node;
         }
 
+        /**
+         * @brief 回放读缓冲中记录的访问（调用方持有独占锁）
+         * 节点没有 enable_shared_from_this，仍在链表中的节点由其前驱的 _next 取得共享指针；
+         * 回放前已被删除的节点 _next 为空，直接跳过。
+         */
+        void drainReadBuffer()
+        {
+            if(!_readBuffer) return;
+            _readBuffer->drain([this](Node* node)
+            {
+                if(node->_next) moveToMostRecent(node->_prev.lock()->_next);
+            });
+        }
+
+        /**
+         * @brief 读缓冲某个条带已满：抢得到独占锁就顺手回放，抢不到说明有其他线程在写，交给它处理
+         */
+        void tryDrainReadBuffer()
+        {
+            std::unique_lock<CacheMutex> lock(_mutex, std::try_to_lock);
+            if(lock.owns_lock()) drainReadBuffer();
+        }
+
     public:
         /**
          * @brief 初始化 LRU 缓存
-         * @param capacity 缓存容量上限
+         * @param capacity 缓存容量上限（所有条目权重之和的上限）
+         * @param weigher 权重函数，默认每个条目计 1
+         * @param bufferedReads 是否开启读缓冲：命中只记录访问，链表调整攒批进行（LRU 顺序变为近似）
          */
-        LRUCache(int capacity)
-            : _capacity(capacity)
+        LRUCache(size_t capacity, Weigher weigher = Weigher(), bool bufferedReads = false)
+            : _capacity(capacity),
+              _usedWeight(0),
+              _weigher(weigher),
+              _mutex(bufferedReads),
+              _readBuffer(bufferedReads ? std::make_unique<ReadBuffer<Node>>() : nullptr)
         {
             // 创建虚拟头尾节点（Sentinel Nodes），简化边界条件判断
             _head = std::make_shared<Node>(Key(), Value());
@@ -130,64 +198,405 @@ namespace myCache
             _tail->_prev = _head;
         }
 
-        ~LRUCache() override = default;
+        /**
+         * @brief 逐个断开 _next 链接后再释放
+         * 节点之间以 shared_ptr 串联，直接析构会沿链表递归释放，条目数达到百万级时会栈溢出
+         */
+        ~LRUCache() override
+        {
+            NodePtr node = _head;
+            while(node)
+            {
+                NodePtr next = std::move(node->_next);
+                node = std::move(next);
+            }
+        }
         
-        void put(Key key, Value value) override
+        void put(const Key& key, const Value& value) override
         {
-            if(_capacity <= 0) return;
-            
-            std::lock_guard<std::mutex> lock(_mutex); // 线程安全保证
-            auto it = _nodeMap.find(key);
+            putImpl(key, _nodeMap.hashOf(key), value);
+        }
+
+        void put(const Key& key, Value&& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), std::move(value));
+        }
+
+        bool get(const Key& key, Value& value) override
+        {
+            return getImpl(key, value);
+        }
+
+        Value get(const Key& key) override
+        {
+            Value value{};
+            if(get(key, value))
+                return value;
+            return value; // 未找到则返回默认值
+        }
+
+        /**
+         * @brief 异构查找版本：std::string Key 可以直接用 string_view / const char* 查找，不构造临时字符串
+         */
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        bool get(const K& key, Value& value)
+        {
+            return getImpl(key, value);
+        }
+
+        template<class K, EnableIfLookupKey<Key, K> = 0>
+        Value get(const K& key)
+        {
+            Value value{};
+            getImpl(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：命中时在锁内以 const 引用调用 fn(value)
+         * 对缓存的影响与 get 相同（节点移到最近使用端）。fn 中不能再访问本缓存，否则会死锁；
+         * 开启读缓冲时 fn 在共享锁内执行，可能与其他读线程的 fn 并发。
+         * key 可以是 Key 或其异构查找类型。
+         * @return 是否命中
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            return readImpl(key, _nodeMap.hashOf(key), std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 带预先算好哈希的读写接口，供分片路由复用同一个哈希值
+         * hash 必须等于 cacheHashOf<Key>(key)，否则查找结果未定义
+         */
+        template<class K>
+        bool getWithHash(const K& key, uint64_t hash, Value& value)
+        {
+            return readImpl(key, hash, [&value](const Value& stored) { value = stored; });
+        }
+
+        template<class K, class Fn>
+        bool visitWithHash(const K& key, uint64_t hash, Fn&& fn)
+        {
+            return readImpl(key, hash, std::forward<Fn>(fn));
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, const Value& value)
+        {
+            putImpl(key, hash, value);
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, Value&& value)
+        {
+            putImpl(key, hash, std::move(value));
+        }
+
+        /**
+         * @brief 批量读取：先算好全部哈希，整批只加一次锁，探测时提前预取后面 Key 的索引组
+         * @param values 输出数组，长度不小于 count；命中的位置写入值，未命中的位置保持不变
+         * @param found 输出数组（可为空），记录每个位置是否命中
+         * @return 命中个数
+         */
+        size_t multiGet(const Key* keys, size_t count, Value* values, bool* found = nullptr)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = _nodeMap.hashOf(keys[i]);
+            if(found) std::fill(found, found + count, false);
+            return visitBatchWithHash(keys, hashes.data(), nullptr, count, [values, found](size_t i, const Value& stored)
+            {
+                values[i] = stored;
+                if(found) found[i] = true;
+            });
+        }
+
+        /**
+         * @brief 批量写入：哈希与权重在锁外算好，整批只加一次锁
+         */
+        void multiPut(const std::pair<Key, Value>* entries, size_t count)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = _nodeMap.hashOf(entries[i].first);
+            putBatchWithHash(entries, hashes.data(), nullptr, count);
+        }
+
+        /**
+         * @brief 批量读取的底层版本，供分片路由按分片分组后调用
+         * 依次处理 indices[0..count) 指向的 Key（indices 为空时处理 0..count-1），hashes 按原下标给出；
+         * 命中时以原下标调用 fn(index, const Value&)，对缓存的影响与逐个 get 相同
+         * @return 命中个数
+         */
+        template<class Fn>
+        size_t visitBatchWithHash(const Key* keys, const uint64_t* hashes, const uint32_t* indices, size_t count, Fn&& fn)
+        {
+            auto at = [indices](size_t n) -> size_t { return indices ? indices[n] : n; };
+            auto hashAt = [hashes, &at](size_t n) { return hashes[at(n)]; };
+            size_t hits = 0;
+            if(!_readBuffer)
+            {
+                std::unique_lock<CacheMutex> lock(_mutex);
+                for(size_t n = 0; n < count; ++n)
+                {
+                    _nodeMap.prefetchBatch(n, count, hashAt);
+                    size_t i = at(n);
+                    if(visitLocked(keys[i], hashes[i], [&fn, i](const Value& stored) { fn(i, stored); })) ++hits;
+                }
+                return hits;
+            }
+
+            bool shouldDrain = false;
+            {
+                std::shared_lock<CacheMutex> lock(_mutex);
+                for(size_t n = 0; n < count; ++n)
+                {
+                    _nodeMap.prefetchBatch(n, count, hashAt);
+                    size_t i = at(n);
+                    auto it = _nodeMap.find(keys[i], hashes[i]);
+                    if(it == _nodeMap.end()) continue;
+                    fn(i, static_cast<const Value&>(it->mapped->getValue()));
+                    if(_readBuffer->record(it->mapped.get())) shouldDrain = true;
+                    ++hits;
+                }
+            }
+            if(shouldDrain) tryDrainReadBuffer();
+            return hits;
+        }
+
+        /**
+         * @brief 批量写入的底层版本，下标约定与 visitBatchWithHash 相同
+         */
+        void putBatchWithHash(const std::pair<Key, Value>* entries, const uint64_t* hashes, const uint32_t* indices, size_t count)
+        {
+            auto at = [indices](size_t n) -> size_t { return indices ? indices[n] : n; };
+            auto hashAt = [hashes, &at](size_t n) { return hashes[at(n)]; };
+            std::vector<size_t> weights(count);
+            for(size_t n = 0; n < count; ++n) weights[n] = _weigher(entries[at(n)].first, entries[at(n)].second);
+
+            std::unique_lock<CacheMutex> lock(_mutex);
+            for(size_t n = 0; n < count; ++n)
+            {
+                _nodeMap.prefetchBatch(n, count, hashAt);
+                size_t i = at(n);
+                putLocked(entries[i].first, entries[i].second, weights[n], hashes[i]);
+            }
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不影响访问顺序）
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            std::shared_lock<CacheMutex> lock(_mutex);
+            return _nodeMap.find(key) != _nodeMap.end();
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        template<class K>
+        void remove(const K& key)
+        {
+            std::unique_lock<CacheMutex> lock(_mutex);
+            removeLocked(key);
+        }
+
+        /**
+         * @brief 当前已占用的权重总和
+         */
+        size_t usedWeight()
+        {
+            std::shared_lock<CacheMutex> lock(_mutex);
+            return _usedWeight;
+        }
+
+        /**
+         * @brief 当前容量（权重预算）
+         */
+        size_t capacity()
+        {
+            std::shared_lock<CacheMutex> lock(_mutex);
+            return _capacity;
+        }
+
+        /**
+         * @brief 调整容量（权重预算），缩小时立即淘汰最久未使用的条目直到回到预算之内
+         * 供分片缓存在分片之间挪动配额（见 CapacityBalancer）
+         */
+        void setCapacity(size_t capacity)
+        {
+            std::unique_lock<CacheMutex> lock(_mutex);
+            drainReadBuffer(); // 先回放，淘汰才能看到最新的顺序，也不会释放缓冲中的节点
+            _capacity = capacity;
+            while(!_nodeMap.empty() && _usedWeight > _capacity)
+            {
+                evictLeastRecent();
+            }
+        }
+
+    protected:
+        /**
+         * 以下接口不加锁，供派生类或 LRUKCache 在 cacheMutex() 的一次独占锁内组合多个步骤；
+         * ConcurrentCache 用自己的写锁串行化调用，本类的锁不参与
+         */
+        CacheMutex& cacheMutex() { return _mutex; }
+
+        size_t weigh(const Key& key, const Value& value) { return _weigher(key, value); }
+
+        /**
+         * @brief 命中时把节点移到最近使用端并以 const 引用调用 fn(value)（调用方持有独占锁）
+         */
+        template<class K, class Fn>
+        bool visitLocked(const K& key, Fn&& fn)
+        {
+            return visitLocked(key, _nodeMap.hashOf(key), std::forward<Fn>(fn));
+        }
+
+        template<class K, class Fn>
+        bool visitLocked(const K& key, uint64_t hash, Fn&& fn)
+        {
+            auto it = _nodeMap.find(key, hash);
+            if(it == _nodeMap.end()) return false;
+            moveToMostRecent(it->mapped);
+            fn(static_cast<const Value&>(it->mapped->getValue()));
+            return true;
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中，不影响访问顺序（调用方持有锁）
+         */
+        template<class K>
+        bool containsLocked(const K& key, uint64_t hash)
+        {
+            return _nodeMap.find(key, hash) != _nodeMap.end();
+        }
+
+        /**
+         * @brief 写入已算好权重的条目（调用方持有独占锁）
+         */
+        template<class V>
+        void putLocked(const Key& key, V&& value, size_t weight)
+        {
+            putLocked(key, std::forward<V>(value), weight, _nodeMap.hashOf(key));
+        }
+
+        template<class V>
+        void putLocked(const Key& key, V&& value, size_t weight, uint64_t hash)
+        {
+            if(_capacity == 0) return;
+            drainReadBuffer(); // 先回放积攒的访问，淘汰才能看到最新的顺序，也不会释放缓冲中的节点
+            auto it = _nodeMap.find(key, hash);
+            if(weight > _capacity)
+            {
+                // 单个条目超过整个预算，无法存放：拒绝写入，同时丢弃旧值避免读到过期数据
+                if(it != _nodeMap.end()) eraseNode(it);
+                return;
+            }
             if(it != _nodeMap.end())
             {
-                updateExistringNode(it->second, value);
+                updateExistringNode(it->mapped, std::forward<V>(value), weight);
                 return;
             }
-            addNewNode(key, value);
+            addNewNode(key, std::forward<V>(value), weight, hash);
         }
 
-        bool get(Key key, Value& value) override
+        /**
+         * @brief 删除条目（调用方持有独占锁）
+         */
+        template<class K>
+        void removeLocked(const K& key)
         {
-            std::lock_guard<std::mutex> lock(_mutex);
-            auto it = _nodeMap.find(key);
+            removeLocked(key, _nodeMap.hashOf(key));
+        }
+
+        template<class K>
+        void removeLocked(const K& key, uint64_t hash)
+        {
+            drainReadBuffer(); // 先回放，保证缓冲中不会残留即将释放的节点
+            auto it = _nodeMap.find(key, hash);
             if(it != _nodeMap.end())
             {
-                moveToMostRecent(it->second); // 访问即更新位置
-                value = it->second->getValue();
-                return true;
+                eraseNode(it);
             }
-            return false;
         }
 
-        Value get(Key key) override
+    private:
+        /**
+         * @brief 读取逻辑：Key 与异构查找类型共用
+         */
+        template<class K>
+        bool getImpl(const K& key, Value& value)
         {
-            Value value;
-            if(get(key, value))
-                return value;
-            return value; // 未找到则返回默认值
+            return readImpl(key, _nodeMap.hashOf(key), [&value](const Value& stored) { value = stored; });
         }
 
         /**
-         * @brief 手动删除指定 Key 的缓存项
+         * @brief 命中时以 const 引用调用 fn(value)，get 与 visit 共用
+         * 未开启读缓冲：独占锁内直接把节点移到最近使用端；
+         * 开启读缓冲：共享锁内只查找并记录访问，条带满时再尝试回放。
+         * 哈希在加锁前算好，临界区内只做探测。
          */
-        void remove(Key key)
+        template<class K, class Fn>
+        bool readImpl(const K& key, uint64_t hash, Fn&& fn)
         {
-            std::lock_guard<std::mutex> lock(_mutex);
-            auto it = _nodeMap.find(key);
-            if(it != _nodeMap.end())
+            if(!_readBuffer)
             {
-                removeNode(it->second);
-                _nodeMap.erase(it);
+                std::unique_lock<CacheMutex> lock(_mutex);
+                return visitLocked(key, hash, std::forward<Fn>(fn)); // 访问即更新位置
             }
+
+            bool shouldDrain;
+            {
+                std::shared_lock<CacheMutex> lock(_mutex);
+                auto it = _nodeMap.find(key, hash);
+                if(it == _nodeMap.end()) return false;
+                fn(static_cast<const Value&>(it->mapped->getValue()));
+                shouldDrain = _readBuffer->record(it->mapped.get());
+            }
+            if(shouldDrain) tryDrainReadBuffer();
+            return true;
+        }
+
+        /**
+         * @brief 写入逻辑：两个 put 重载共用，value 按原本的值类别转发（左值拷贝、右值移动）
+         */
+        template<class V>
+        void putImpl(const Key& key, uint64_t hash, V&& value)
+        {
+            // 容量可能被 setCapacity 调整，零容量的判断只能放在锁内（putLocked）
+            size_t weight = _weigher(key, value);
+            
+            std::unique_lock<CacheMutex> lock(_mutex); // 线程安全保证
+            putLocked(key, std::forward<V>(value), weight, hash);
+        }
+
+        /**
+         * @brief 从链表和 map 中同时删除节点，并归还其权重
+         */
+        void eraseNode(typename NodeMap::iterator it)
+        {
+            removeNode(it->mapped);
+            _usedWeight -= it->mapped->_weight;
+            _nodeMap.erase(it);
         }
 
     private:
-        int _capacity;           // 缓存最大容量
-        NodeMap _nodeMap;        // 哈希表：Key -> 节点指针，实现 O(1) 查找
-        std::mutex _mutex;       // 互斥锁，支持多线程安全
+        size_t _capacity;        // 缓存最大容量（权重预算）
+        size_t _usedWeight;      // 当前已占用的权重
+        Weigher _weigher;        // 条目权重函数
+        NodeMap _nodeMap;        // 标签分组索引：Key -> 节点指针，实现 O(1) 查找
+        CacheMutex _mutex;       // 缓存锁：写操作独占；开启读缓冲时命中只取共享锁
+        std::unique_ptr<ReadBuffer<Node>> _readBuffer; // 读缓冲，未开启时为空
         NodePtr _head;           // 虚拟头节点：指向“最久未使用”的方向
         NodePtr _tail;           // 虚拟尾节点：指向“最近使用”的方向
     };
+
+    /**
+     * @brief 共享值模式的 LRU 缓存
+     * 节点中存放 SharedValue<Value>，get 在锁内只拷贝句柄，大对象的读取发生在锁外。
+     * 按字节计量时可使用 SharedValueWeigher<Key, Value> 按句柄指向的对象估算权重。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, SharedValue<Value>>>
+    using SharedLRUCache = LRUCache<Key, SharedValue<Value>, Weigher>;
 }
 
 #endif
@@ -3,117 +3,466 @@
 #ifndef __LRUK_HPP__
 #define __LRUK_HPP__
  
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include "LRU.hpp"
+#include "../Common/TagIndex.hpp"
  
 namespace myCache
 {
+    /**
+     * @brief LRU-K 的历史队列：访问计数、暂存值与 LRU 链接合并在同一个条目中
+     * 每次访问只做一次索引查找，计数 +1 与移到最近使用端都在同一个条目上完成。
+     * 条目预先分配在连续的节点池中，链表指针为 32 位下标（与 PoolLRUCache 相同）；
+     * 暂存值放在单独分配的堆对象中，只在 Key 第二次及以后被写入时才分配；没有暂存值的 Key 只占一个空指针。
+     * 不加锁，由 LRUKCache 的锁保护。
+     */
+    template<class Key, class Value>
+    class LRUKHistory
+    {
+    public:
+        typedef uint32_t Index;
+        static constexpr Index NONE = 0; // 下标 0 固定为哨兵，同时表示“没有条目”
+ 
+    private:
+        struct Slot
+        {
+            Key _key;
+            std::unique_ptr<Value> _value; // 尚未晋升的数据，只被读过的 Key 为空
+            size_t _count;                 // 访问次数
+            Index _prev;
+            Index _next;
+ 
+            Slot() : _key(), _count(0), _prev(NONE), _next(NONE) {}
+        };
+ 
+        struct SlotKeyOf
+        {
+            const std::vector<Slot>* pool;
+            const Key& operator()(Index idx) const { return (*pool)[idx]._key; }
+        };
+        typedef TagIndex<Key, Index, SlotKeyOf> NodeMap;
+ 
+        void unlink(Index idx)
+        {
+            Slot& slot = _pool[idx];
+            _pool[slot._prev]._next = slot._next;
+            _pool[slot._next]._prev = slot._prev;
+        }
+ 
+        /**
+         * @brief 挂到链表尾部（哨兵之前，即最近访问的位置）
+         */
+        void linkAtTail(Index idx)
+        {
+            Slot& slot = _pool[idx];
+            Slot& sentinel = _pool[NONE];
+            slot._prev = sentinel._prev;
+            slot._next = NONE;
+            _pool[sentinel._prev]._next = idx;
+            sentinel._prev = idx;
+        }
+ 
+        /**
+         * @brief 归还槽位到空闲链表（复用 _next 字段），同时释放暂存值
+         */
+        void releaseSlot(Index idx)
+        {
+            _pool[idx]._value.reset();
+            _pool[idx]._count = 0;
+            _pool[idx]._next = _freeHead;
+            _freeHead = idx;
+        }
+ 
+    public:
+        /**
+         * @param capacity 最多记录多少个 Key 的访问历史，节点池在构造时一次分配完毕
+         */
+        explicit LRUKHistory(size_t capacity)
+            : _capacity(capacity),
+              _freeHead(NONE),
+              _nodeMap(SlotKeyOf{&_pool})
+        {
+            _pool.resize(_capacity + 1);
+            _nodeMap.reserve(_capacity);
+            // 串起空闲链表：1 -> 2 -> ... -> capacity -> 0(结束)
+            for(size_t i = _capacity; i >= 1; --i)
+            {
+                _pool[i]._next = _freeHead;
+                _freeHead = static_cast<Index>(i);
+            }
+        }
+ 
+        LRUKHistory(const LRUKHistory&) = delete;
+        LRUKHistory& operator=(const LRUKHistory&) = delete;
+ 
+        /**
+         * @brief 记录一次访问：已有条目计数 +1 并移到最近访问端，否则新建计数为 1 的条目
+         * 历史队列已满时淘汰最久未访问的条目（连同它的暂存值）
+         * @param hash 必须等于 cacheHashOf<Key>(key)，与主缓存共用调用方算好的同一个值
+         * @return 条目下标，在下一次修改历史队列之前有效；容量为 0 时不保留条目，返回 NONE
+         */
+        Index access(const Key& key, uint64_t hash)
+        {
+            auto it = _nodeMap.find(key, hash);
+            if(it != _nodeMap.end())
+            {
+                Index idx = it->mapped;
+                ++_pool[idx]._count;
+                if(_pool[NONE]._prev != idx)
+                {
+                    unlink(idx);
+                    linkAtTail(idx);
+                }
+                return idx;
+            }
+            if(_capacity == 0) return NONE;
+            if(_freeHead == NONE)
+            {
+                Index victim = _pool[NONE]._next;
+                unlink(victim);
+                _nodeMap.erase(_pool[victim]._key);
+                releaseSlot(victim);
+            }
+            Index idx = _freeHead;
+            _freeHead = _pool[idx]._next;
+            _pool[idx]._key = key;
+            _pool[idx]._count = 1;
+            linkAtTail(idx);
+            _nodeMap.insert(idx, hash);
+            return idx;
+        }
+ 
+        /**
+         * @brief 条目的访问次数（不保留条目时视为本次是第一次访问）
+         */
+        size_t count(Index idx) const { return idx == NONE ? 1 : _pool[idx]._count; }
+ 
+        /**
+         * @brief 条目的暂存值，没有时返回空指针
+         */
+        Value* value(Index idx) { return idx == NONE ? nullptr : _pool[idx]._value.get(); }
+ 
+        /**
+         * @brief 暂存尚未晋升的数据（已有暂存值时原地覆盖，不重新分配）
+         */
+        template<class V>
+        void setValue(Index idx, V&& value)
+        {
+            if(idx == NONE) return;
+            std::unique_ptr<Value>& stored = _pool[idx]._value;
+            if(stored) *stored = std::forward<V>(value);
+            else stored = std::make_unique<Value>(std::forward<V>(value));
+        }
+ 
+        /**
+         * @brief 删除条目（晋升或手动删除时调用）
+         */
+        void erase(Index idx)
+        {
+            if(idx == NONE) return;
+            unlink(idx);
+            _nodeMap.erase(_pool[idx]._key);
+            releaseSlot(idx);
+        }
+ 
+        void remove(const Key& key, uint64_t hash)
+        {
+            auto it = _nodeMap.find(key, hash);
+            if(it != _nodeMap.end()) erase(it->mapped);
+        }
+ 
+    private:
+        size_t _capacity;         // 最多记录的 Key 数
+        std::vector<Slot> _pool;  // 节点池，下标 0 为哨兵：_next 指向最久未访问，_prev 指向最近访问
+        Index _freeHead;          // 空闲链表头
+        NodeMap _nodeMap;         // 标签分组索引：Key -> 池下标
+    };
+ 
     /**
      * @brief LRU-K 缓存类
      * 核心思想：数据访问满 K 次才进入热点缓存，能够有效过滤偶发性的访问请求。
-     * 继承自 LRUCache，作为其“主缓存（热点队列）”。
+     * 主缓存（热点队列）是一个私有的 LRUCache 成员，容量同样按 Weigher 计量；
+     * 历史队列只记录第一次出现的 Key 的访问次数，不暂存它的值：一次性扫描写入的大量冷数据不会各自分配并拷贝一份值。
+     * 因此第一次 put 之后紧接着的 get 即使满 K 次也不命中（没有值可晋升），需要调用方重新 put；
+     * 连续两次 put 时由第二次 put 带来值（K = 2 时直接晋升，K 更大时从第二次起暂存）。
+     * 不继承 LRUCache，它的 visit / *WithHash / 批量接口都会绕过历史队列，不能暴露给调用方；
+     * 本类提供自己的同名接口，每个 Key 都照常计入历史。
+     * 线程安全：主缓存与历史队列都由主缓存的同一把锁保护，每次 get / put（以及整批 multiGet / multiPut）只加锁一次。
+     * 哈希在加锁前算好，主缓存索引与历史队列索引共用这一个值；分片路由可以通过 *WithHash 接口直接传入。
      */
-    template <class Key, class Value>
-    class LRUKCache : public LRUCache<Key, Value>
+    template <class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class LRUKCache : public CachePolicy<Key, Value>
     {
+        typedef LRUCache<Key, Value, Weigher> MainCache;
+        typedef LRUKHistory<Key, Value> History;
+ 
     public:
         /**
          * @brief 构造函数
          * @param capacity 主缓存（热点队列）容量
-         * @param historyCapacity 历史队列（访问不足K次）容量
-         * @param k 晋升阈值：访问达到 k 次的数据会被移入主缓存
+         * @param historyCapacity 历史队列（访问不足K次）容量，按 Key 数计
+         * @param k 晋升阈值：访问达到 k 次的数据会被移入主缓存，小于 1 时按 1 处理
+         * @param weigher 主缓存的权重函数
          */
-        LRUKCache(int capacity, int historyCapacity, int k)
-            : LRUCache<Key, Value>(capacity), 
-              _k(k),
-              _historyList(std::make_unique<LRUCache<Key, size_t>>(historyCapacity)) 
+        LRUKCache(size_t capacity, int historyCapacity, int k, Weigher weigher = Weigher())
+            : _mainCache(capacity, weigher),
+              _k(static_cast<size_t>(std::max(k, 1))),
+              _history(historyCapacity > 0 ? historyCapacity : 0)
         {}
  
         /**
          * @brief 获取数据
          * 逻辑：先看热点队列，再更新历史计数。
          */
-        Value get(Key key)
+        bool get(const Key& key, Value& value) override
+        {
+            return getWithHash(key, cacheHashOf<Key>(key), value);
+        }
+ 
+        Value get(const Key& key) override
         {
-            // 1. 尝试从主缓存（热点队列）中读取
             Value value{};
-            bool inMainCache = LRUCache<Key, Value>::get(key, value);
+            get(key, value);
+            return value;
+        }
  
-            // 2. 获取并增加该 Key 的访问历史计数
-            // 如果历史队列中不存在，get 会返回 0（取决于 LRU 内部实现）
-            size_t historyCount = _historyList->get(key);
-            historyCount++;
-            _historyList->put(key, historyCount);
+        /**
+         * @brief 存入数据
+         */
+        void put(const Key& key, const Value& value) override
+        {
+            putWithHash(key, cacheHashOf<Key>(key), value);
+        }
+ 
+        /**
+         * @brief 存入数据（右值版本）
+         */
+        void put(const Key& key, Value&& value) override
+        {
+            putWithHash(key, cacheHashOf<Key>(key), std::move(value));
+        }
+ 
+        /**
+         * @brief 免拷贝读取：命中（或本次访问恰好晋升）时在锁内以 const 引用调用 fn(value)
+         * 与 get 一样计入历史；fn 中不能再访问本缓存，否则会死锁。
+         * @return 是否命中
+         */
+        template<class Fn>
+        bool visit(const Key& key, Fn&& fn)
+        {
+            return visitWithHash(key, cacheHashOf<Key>(key), std::forward<Fn>(fn));
+        }
+ 
+        /**
+         * @brief 带预先算好哈希的读写接口，供分片路由复用同一个哈希值
+         * hash 必须等于 cacheHashOf<Key>(key)，否则查找结果未定义
+         */
+        bool getWithHash(const Key& key, uint64_t hash, Value& value)
+        {
+            return visitWithHash(key, hash, [&value](const Value& stored) { value = stored; });
+        }
+ 
+        template<class Fn>
+        bool visitWithHash(const Key& key, uint64_t hash, Fn&& fn)
+        {
+            std::unique_lock<CacheMutex> lock(_mainCache.cacheMutex());
+            return visitLocked(key, hash, std::forward<Fn>(fn));
+        }
+ 
+        void putWithHash(const Key& key, uint64_t hash, const Value& value)
+        {
+            std::unique_lock<CacheMutex> lock(_mainCache.cacheMutex());
+            putLocked(key, hash, value);
+        }
+ 
+        void putWithHash(const Key& key, uint64_t hash, Value&& value)
+        {
+            std::unique_lock<CacheMutex> lock(_mainCache.cacheMutex());
+            putLocked(key, hash, std::move(value));
+        }
+ 
+        /**
+         * @brief 批量读取：哈希在锁外算好，整批只加一次锁，每个 Key 与 get 一样计入历史并可能晋升
+         * @param values 输出数组，长度不小于 count；命中的位置写入值，未命中的位置保持不变
+         * @param found 输出数组（可为空），记录每个位置是否命中
+         * @return 命中个数
+         */
+        size_t multiGet(const Key* keys, size_t count, Value* values, bool* found = nullptr)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = cacheHashOf<Key>(keys[i]);
+            if(found) std::fill(found, found + count, false);
+            return visitBatchWithHash(keys, hashes.data(), nullptr, count, [values, found](size_t i, const Value& stored)
+            {
+                values[i] = stored;
+                if(found) found[i] = true;
+            });
+        }
+ 
+        /**
+         * @brief 批量写入：哈希在锁外算好，整批只加一次锁，每个条目与 put 一样须满 K 次访问才进入主缓存
+         */
+        void multiPut(const std::pair<Key, Value>* entries, size_t count)
+        {
+            std::vector<uint64_t> hashes(count);
+            for(size_t i = 0; i < count; ++i) hashes[i] = cacheHashOf<Key>(entries[i].first);
+            putBatchWithHash(entries, hashes.data(), nullptr, count);
+        }
+ 
+        /**
+         * @brief 批量读取的底层版本，供分片路由按分片分组后调用
+         * 依次处理 indices[0..count) 指向的 Key（indices 为空时处理 0..count-1），hashes 按原下标给出；
+         * 命中时以原下标调用 fn(index, const Value&)，对缓存的影响与逐个 get 相同
+         * @return 命中个数
+         */
+        template<class Fn>
+        size_t visitBatchWithHash(const Key* keys, const uint64_t* hashes, const uint32_t* indices, size_t count, Fn&& fn)
+        {
+            std::unique_lock<CacheMutex> lock(_mainCache.cacheMutex());
+            size_t hits = 0;
+            for(size_t n = 0; n < count; ++n)
+            {
+                size_t i = indices ? indices[n] : n;
+                if(visitLocked(keys[i], hashes[i], [&fn, i](const Value& stored) { fn(i, stored); })) ++hits;
+            }
+            return hits;
+        }
+ 
+        /**
+         * @brief 批量写入的底层版本，下标约定与 visitBatchWithHash 相同
+         */
+        void putBatchWithHash(const std::pair<Key, Value>* entries, const uint64_t* hashes, const uint32_t* indices, size_t count)
+        {
+            std::unique_lock<CacheMutex> lock(_mainCache.cacheMutex());
+            for(size_t n = 0; n < count; ++n)
+            {
+                size_t i = indices ? indices[n] : n;
+                putLocked(entries[i].first, hashes[i], entries[i].second);
+            }
+        }
+ 
+        /**
+         * @brief 判断 Key 是否在主缓存中（不影响访问顺序与历史计数）
+         */
+        bool contains(const Key& key)
+        {
+            return containsWithHash(key, cacheHashOf<Key>(key));
+        }
+ 
+        bool containsWithHash(const Key& key, uint64_t hash)
+        {
+            std::unique_lock<CacheMutex> lock(_mainCache.cacheMutex());
+            return _mainCache.containsLocked(key, hash);
+        }
+ 
+        /**
+         * @brief 手动删除指定 Key：主缓存中的条目与历史记录一并清除
+         */
+        void remove(const Key& key)
+        {
+            removeWithHash(key, cacheHashOf<Key>(key));
+        }
+ 
+        void removeWithHash(const Key& key, uint64_t hash)
+        {
+            std::unique_lock<CacheMutex> lock(_mainCache.cacheMutex());
+            _mainCache.removeLocked(key, hash);
+            _history.remove(key, hash);
+        }
+ 
+        /**
+         * @brief 主缓存当前已占用的权重总和
+         */
+        size_t usedWeight()
+        {
+            return _mainCache.usedWeight();
+        }
+ 
+    private:
+        /**
+         * @brief 读取逻辑（调用方持有主缓存的锁）：命中或本次晋升时以 const 引用调用 fn(value)
+         */
+        template<class Fn>
+        bool visitLocked(const Key& key, uint64_t hash, Fn&& fn)
+        {
+            // 1. 尝试从主缓存（热点队列）中读取
+            bool inMainCache = _mainCache.visitLocked(key, hash, fn);
+ 
+            // 2. 获取并增加该 Key 的访问历史计数（历史队列中不存在时从 1 开始）
+            typename History::Index idx = _history.access(key, hash);
  
             // 3. 如果主缓存命中，直接返回（因为已在热点队列，只需更新其在 LRU 中的位置）
             if(inMainCache)
             {
-                return value;
+                return true;
             }
  
             // 4. 若主缓存未命中，检查历史访问次数是否达到阈值 K
-            if(historyCount >= _k)
+            if(_history.count(idx) >= _k)
             {
-                auto it = _historyValueMap.find(key);
-                if(it != _historyValueMap.end())
+                Value* stored = _history.value(idx);
+                if(stored)
                 {
-                    // 计数达标，将数据从“历史暂存区”晋升到“主缓存热点队列”
-                    Value storedValue = it->second;  
-                    
-                    // 清理历史记录（不再是“新人”了）
-                    _historyList->remove(key);
-                    _historyValueMap.erase(it);
+                    // 计数达标，将数据从“历史暂存区”晋升到“主缓存热点队列”，并清理历史记录（不再是“新人”了）
+                    fn(static_cast<const Value&>(*stored));
+                    Value promoted = std::move(*stored);
+                    _history.erase(idx);
  
                     // 正式进入主缓存
-                    LRUCache<Key, Value>::put(key, storedValue);
- 
-                    return storedValue;
+                    size_t weight = _mainCache.weigh(key, promoted);
+                    _mainCache.putLocked(key, std::move(promoted), weight, hash);
+                    return true;
                 }
             }
-            
-            // 数据未达标或不存在，返回默认值
-            return value;
+ 
+            // 数据未达标或不存在
+            return false;
         }
  
         /**
-         * @brief 存入数据
+         * @brief 写入逻辑（调用方持有主缓存的锁）：value 按原本的值类别转发，最终只落到主缓存或历史条目中的一处
          */
-        void put(Key key, Value value)
+        template<class V>
+        void putLocked(const Key& key, uint64_t hash, V&& value)
         {
-            // 1. 如果数据已在主缓存中，直接更新其值和热度
-            Value exitingValue{};
-            if(LRUCache<Key, Value>::get(key, exitingValue))
+            // 1. 如果数据已在主缓存中，直接更新其值和热度（visitLocked 只用来判断是否命中，不拷贝旧值）
+            if(_mainCache.visitLocked(key, hash, [](const Value&) {}))
             {
-                LRUCache<Key, Value>::put(key, value);
+                size_t weight = _mainCache.weigh(key, value);
+                _mainCache.putLocked(key, std::forward<V>(value), weight, hash);
                 return;
             }
-            
+ 
             // 2. 如果数据不在主缓存，更新其在历史队列的访问次数
-            size_t historyCount = _historyList->get(key);
-            historyCount++;
-            _historyList->put(key, historyCount);
+            typename History::Index idx = _history.access(key, hash);
  
-            // 3. 将具体数值暂存在映射表中，防止数据在没进主缓存前丢失
-            _historyValueMap[key] = value;
+            // 3. 判定是否达到晋升条件（访问满 K 次）：移除历史信息，将数据“转正”移入主缓存
+            if(_history.count(idx) >= _k)
+            {
+                _history.erase(idx);
+                size_t weight = _mainCache.weigh(key, value);
+                _mainCache.putLocked(key, std::forward<V>(value), weight, hash);
+                return;
+            }
  
-            // 4. 判定是否达到晋升条件（访问满 K 次）
-            if(historyCount >= _k)
+            // 4. 未达标：第一次出现的 Key 只记次数，不暂存值（多数只出现一次，暂存只会白白分配和拷贝）；
+            //    第二次及以后的写入才把具体数值暂存在历史条目中，供之后的访问晋升
+            if(_history.count(idx) > 1)
             {
-                // 移除历史信息
-                _historyList->remove(key);
-                _historyValueMap.erase(key);
-                
-                // 将数据“转正”移入主缓存
-                LRUCache<Key, Value>::put(key, value);
+                _history.setValue(idx, std::forward<V>(value));
             }
         }
  
-    public:
-        int _k;                                              // 进入热点缓存的访问次数门槛
-        std::unique_ptr<LRUCache<Key, size_t>> _historyList; // 历史访问频率队列（内部也是个 LRU）
-        std::unordered_map<Key, Value> _historyValueMap;     // 存储尚未晋升的数据实际内容
+     private:
+        MainCache _mainCache; // 主缓存（热点队列），它的锁同时保护历史队列
+        size_t _k;            // 进入热点缓存的访问次数门槛
+        History _history;     // 历史队列：访问计数 + 暂存值 + LRU 链接
     };
 }
  
@@ -0,0 +1,324 @@
+// PoolLRU.hpp
+
+#ifndef __POOL_LRU_HPP__
+#define __POOL_LRU_HPP__
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <mutex>
+#include "../Common/CachePolicy.hpp"
+#include "../Common/CacheHash.hpp"
+#include "../Common/CacheWeigher.hpp"
+#include "../Common/FlatIndex.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief 基于连续节点池的 LRU 缓存实现
+     * 与 LRUCache 的区别：节点不再逐个 make_shared，而是预先分配在一块连续的 vector 中，
+     * 链表指针改为 32 位下标。这样移动节点时没有原子引用计数、没有 weak_ptr::lock()，
+     * 每个条目也只剩一个哈希表节点 + 池中一个槽位。
+     * 逻辑与 LRUCache 一致：最近访问的放在尾部，最久未访问的放在头部。
+     * 容量同样按 Weigher 计算的权重累计；节点池随需增长（下标保持稳定），按条目计数（UnitWeigher）时
+     * 构造时最多预留 MAX_RESERVE 个槽位，容量很大时不会在构造时就占满内存。
+     * 下标为 32 位，条目数上限为 MAX_ENTRIES（约 42 亿）：按条目计数时容量被截断到该值，
+     * 按其他权重计量时条目数到达上限后写入新条目会先淘汰最久未使用的条目。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class PoolLRUCache : public CachePolicy<Key, Value>
+    {
+        typedef uint32_t Index;
+
+        /**
+         * @brief 池中的一个槽位
+         * _prev / _next 为池内下标，下标 0 固定为哨兵节点
+         */
+        struct Slot
+        {
+            Key _key;
+            Value _value;
+            size_t _weight;
+            Index _prev;
+            Index _next;
+
+            Slot() : _key(), _value(), _weight(0), _prev(0), _next(0) {}
+        };
+
+        static const Index SENTINEL = 0; // 哨兵下标：_next 指向最久未使用，_prev 指向最近使用
+
+    public:
+        static constexpr size_t MAX_ENTRIES = std::numeric_limits<Index>::max() - 1; // 下标 0 为哨兵，其余下标都要能放进 Index
+        static constexpr size_t MAX_RESERVE = 1 << 16; // 按条目计数时构造阶段最多预留的槽位数，其余随写入增长
+
+    private:
+        // 索引中只存 4 字节的池下标，Key 从池中对应槽位取出
+        struct SlotKeyOf
+        {
+            const std::vector<Slot>* pool;
+            const Key& operator()(Index idx) const { return (*pool)[idx]._key; }
+        };
+        typedef FlatIndex<Key, Index, SlotKeyOf> NodeMap;
+
+    private:
+        /**
+         * @brief 将槽位从链表中断开
+         */
+        void unlink(Index idx)
+        {
+            Slot& slot = _pool[idx];
+            _pool[slot._prev]._next = slot._next;
+            _pool[slot._next]._prev = slot._prev;
+        }
+
+        /**
+         * @brief 将槽位挂到链表尾部（哨兵之前，即最近使用的位置）
+         */
+        void linkAtTail(Index idx)
+        {
+            Slot& slot = _pool[idx];
+            Slot& sentinel = _pool[SENTINEL];
+            slot._prev = sentinel._prev;
+            slot._next = SENTINEL;
+            _pool[sentinel._prev]._next = idx;
+            sentinel._prev = idx;
+        }
+
+        void moveToMostRecent(Index idx)
+        {
+            if(_pool[SENTINEL]._prev == idx) return; // 已经在尾部
+            unlink(idx);
+            linkAtTail(idx);
+        }
+
+        /**
+         * @brief 驱逐最久未使用的节点，其槽位进入空闲链表
+         */
+        void evictLeastRecent()
+        {
+            Index victim = _pool[SENTINEL]._next;
+            unlink(victim);
+            _nodeMap.erase(_pool[victim]._key);
+            releaseSlot(victim);
+        }
+
+        /**
+         * @brief 获取一个可用槽位
+         * 空闲链表是后进先出的，缓存满时刚被驱逐的槽位会被立即复用
+         */
+        Index acquireSlot()
+        {
+            if(_freeHead == SENTINEL)
+            {
+                _pool.emplace_back();
+                return static_cast<Index>(_pool.size() - 1);
+            }
+            Index idx = _freeHead;
+            _freeHead = _pool[idx]._next;
+            return idx;
+        }
+
+        /**
+         * @brief 归还槽位到空闲链表（空闲链表复用 _next 字段）
+         */
+        void releaseSlot(Index idx)
+        {
+            _usedWeight -= _pool[idx]._weight;
+            _pool[idx]._weight = 0;
+            _pool[idx]._value = Value(); // 及时释放值占用的资源
+            _pool[idx]._next = _freeHead;
+            _freeHead = idx;
+        }
+
+    public:
+        /**
+         * @brief 初始化缓存
+         * 只创建哨兵；按条目计数时预留 min(capacity, MAX_RESERVE) 个槽位，减少写满之前节点池的重新分配
+         * @param capacity 缓存容量上限（所有条目权重之和的上限）；按条目计数时超过 MAX_ENTRIES 的部分被截断
+         * @param weigher 权重函数，默认每个条目计 1
+         */
+        PoolLRUCache(size_t capacity, Weigher weigher = Weigher())
+            : _capacity(std::is_same<Weigher, UnitWeigher<Key, Value>>::value ? std::min(capacity, MAX_ENTRIES) : capacity),
+              _usedWeight(0),
+              _weigher(weigher),
+              _freeHead(SENTINEL),
+              _nodeMap(SlotKeyOf{&_pool})
+        {
+            if(std::is_same<Weigher, UnitWeigher<Key, Value>>::value)
+            {
+                size_t reserved = std::min(_capacity, MAX_RESERVE);
+                _pool.reserve(reserved + 1);
+                _nodeMap.reserve(reserved);
+            }
+            _pool.resize(1);
+        }
+
+        ~PoolLRUCache() override = default;
+
+        void put(const Key& key, const Value& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), value);
+        }
+
+        void put(const Key& key, Value&& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), std::move(value));
+        }
+
+        bool get(const Key& key, Value& value) override
+        {
+            return getWithHash(key, _nodeMap.hashOf(key), value);
+        }
+
+        Value get(const Key& key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：命中时在锁内以 const 引用调用 fn(value)
+         * 对缓存的影响与 get 相同。fn 中不能再访问本缓存，否则会死锁。
+         * @return 是否命中
+         */
+        template<class K, class Fn>
+        bool visit(const K& key, Fn&& fn)
+        {
+            return visitWithHash(key, _nodeMap.hashOf(key), std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 带预先算好哈希的读写接口，供分片路由复用同一个哈希值
+         * hash 必须等于 cacheHashOf<Key>(key)，否则查找结果未定义
+         */
+        template<class K>
+        bool getWithHash(const K& key, uint64_t hash, Value& value)
+        {
+            return visitWithHash(key, hash, [&value](const Value& stored) { value = stored; });
+        }
+
+        template<class K, class Fn>
+        bool visitWithHash(const K& key, uint64_t hash, Fn&& fn)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _nodeMap.find(key, hash);
+            if(it == _nodeMap.end()) return false;
+            moveToMostRecent(it->mapped);
+            fn(static_cast<const Value&>(_pool[it->mapped]._value));
+            return true;
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, const Value& value)
+        {
+            putImpl(key, hash, value);
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, Value&& value)
+        {
+            putImpl(key, hash, std::move(value));
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不影响访问顺序）
+         */
+        template<class K>
+        bool contains(const K& key)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _nodeMap.find(key) != _nodeMap.end();
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        void remove(const Key& key)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _nodeMap.find(key);
+            if(it != _nodeMap.end())
+            {
+                eraseSlot(it);
+            }
+        }
+
+        /**
+         * @brief 当前已占用的权重总和
+         */
+        size_t usedWeight()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _usedWeight;
+        }
+
+    private:
+        /**
+         * @brief 写入逻辑：两个 put 重载共用，value 按原本的值类别转发（左值拷贝、右值移动）
+         */
+        template<class V>
+        void putImpl(const Key& key, uint64_t hash, V&& value)
+        {
+            if(_capacity == 0) return;
+            size_t weight = _weigher(key, value);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _nodeMap.find(key, hash);
+            if(weight > _capacity)
+            {
+                // 单个条目超过整个预算，无法存放：拒绝写入，同时丢弃旧值避免读到过期数据
+                if(it != _nodeMap.end()) eraseSlot(it);
+                return;
+            }
+            if(it != _nodeMap.end())
+            {
+                Slot& slot = _pool[it->mapped];
+                slot._value = std::forward<V>(value);
+                _usedWeight = _usedWeight - slot._weight + weight;
+                slot._weight = weight;
+                moveToMostRecent(it->mapped);
+                while(_usedWeight > _capacity)
+                {
+                    evictLeastRecent(); // 该节点已在尾部，不会被自己淘汰
+                }
+                return;
+            }
+            // 条目数到达下标上限时同样需要腾出槽位（只在按其他权重计量时可能发生）
+            while(!_nodeMap.empty() && (_usedWeight + weight > _capacity || _nodeMap.size() >= MAX_ENTRIES))
+            {
+                evictLeastRecent();
+            }
+            Index idx = acquireSlot();
+            _pool[idx]._key = key;
+            _pool[idx]._value = std::forward<V>(value);
+            _pool[idx]._weight = weight;
+            _usedWeight += weight;
+            linkAtTail(idx);
+            _nodeMap.insert(idx, hash);
+        }
+
+        /**
+         * @brief 从链表和 map 中同时删除节点，并归还其槽位
+         */
+        void eraseSlot(typename NodeMap::iterator it)
+        {
+            Index idx = it->mapped;
+            unlink(idx);
+            _nodeMap.erase(it);
+            releaseSlot(idx);
+        }
+
+    private:
+        size_t _capacity;           // 缓存最大容量（权重预算）
+        size_t _usedWeight;         // 当前已占用的权重
+        Weigher _weigher;           // 条目权重函数
+        std::vector<Slot> _pool;    // 连续节点池，下标 0 为哨兵
+        Index _freeHead;            // 空闲槽位链表头，SENTINEL 表示没有空闲槽位
+        NodeMap _nodeMap;           // 开放寻址索引：Key -> 池下标
+        std::mutex _mutex;          // 互斥锁，支持多线程安全
+    };
+}
+
+#endif
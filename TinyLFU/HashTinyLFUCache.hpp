@@ -0,0 +1,110 @@
+// HashTinyLFUCache.hpp
+
+#ifndef __HASH_TINY_LFU_CACHE_HPP__
+#define __HASH_TINY_LFU_CACHE_HPP__
+
+#include "TinyLFUCache.hpp"
+#include "../Common/ShardArray.hpp"
+#include <vector>
+#include <thread>
+#include <utility>
+
+namespace myCache
+{
+    /**
+     * @brief HashTinyLFUCache 模板类
+     * 与 HashLRUCache 相同的分片方式，每个分片是一个完整的 TinyLFUCache（窗口、分段主缓存与 Sketch 各自独立）。
+     * 分片由哈希最高几位选出，分片内部的 Sketch 与索引使用同一个哈希的其余位，分布互不影响。
+     * 容量（权重预算）与 Sketch 的预期条目数都按分片均分，Weigher 会传递给每个分片。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class HashTinyLFUCache
+    {
+    private:
+        /**
+         * @brief 哈希定位函数：与分片内部索引相同的混淆哈希（cacheHashOf），取最高几位选择分片，
+         * 同一个值再传给分片作为索引与 Sketch 的哈希，每次读写只计算一次
+         */
+        uint64_t Hash(const Key& key)
+        {
+            return cacheHashOf<Key>(key);
+        }
+
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 总缓存容量（所有条目权重之和的上限）
+         * @param sliceNum 分片数量，不大于 0 时取硬件并发核心数，向上取整为 2 的幂
+         * @param weigher 权重函数，默认每个条目计 1
+         * @param expectedEntries 预期总条目数，为 0 时取 capacity
+         */
+        HashTinyLFUCache(size_t capacity, int sliceNum, Weigher weigher = Weigher(), size_t expectedEntries = 0)
+            : _capacity(capacity),
+              _router(sliceNum),
+              // 容量向上取整均分到各分片，分片连续存放在按缓存行对齐的数组中
+              _tinyLfuSliceCaches(_router.shardCount(), _router.perShard(capacity), weigher,
+                                  _router.perShard(expectedEntries))
+        {}
+
+        void put(const Key& key, const Value& value)
+        {
+            uint64_t hash = Hash(key);
+            _tinyLfuSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, value);
+        }
+
+        void put(const Key& key, Value&& value)
+        {
+            uint64_t hash = Hash(key);
+            _tinyLfuSliceCaches[_router.shardOf(hash)].putWithHash(key, hash, std::move(value));
+        }
+
+        bool get(const Key& key, Value& value)
+        {
+            uint64_t hash = Hash(key);
+            return _tinyLfuSliceCaches[_router.shardOf(hash)].getWithHash(key, hash, value);
+        }
+
+        Value get(const Key& key)
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：在对应分片的锁内以 const 引用调用 fn(value)
+         * @return 是否命中
+         */
+        template<class Fn>
+        bool visit(const Key& key, Fn&& fn)
+        {
+            uint64_t hash = Hash(key);
+            return _tinyLfuSliceCaches[_router.shardOf(hash)].visitWithHash(key, hash, std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不计频次）
+         */
+        bool contains(const Key& key)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            return _tinyLfuSliceCaches[sliceIndex].contains(key);
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项
+         */
+        void remove(const Key& key)
+        {
+            size_t sliceIndex = _router.shardOf(Hash(key));
+            _tinyLfuSliceCaches[sliceIndex].remove(key);
+        }
+
+    private:
+        size_t _capacity; // 总容量
+        ShardRouter _router; // 分片路由：分片数为 2 的幂
+        ShardArray<TinyLFUCache<Key, Value, Weigher>> _tinyLfuSliceCaches;
+    };
+}
+
+#endif
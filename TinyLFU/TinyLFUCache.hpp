@@ -0,0 +1,428 @@
+// TinyLFUCache.hpp
+
+#ifndef __TINY_LFU_CACHE_HPP__
+#define __TINY_LFU_CACHE_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../Common/CachePolicy.hpp"
+#include "../Common/CacheWeigher.hpp"
+#include "../Common/FrequencySketch.hpp"
+#include "../Common/TagIndex.hpp"
+
+namespace myCache
+{
+    /**
+     * @brief W-TinyLFU 缓存
+     * 其他策略总是淘汰一个旧条目来接纳新条目，只访问一次的 Key（one-hit wonder）也会把有价值的条目挤出去。
+     * 这里在主缓存前加一道准入过滤：新条目先进入很小的窗口 LRU（约 1% 容量），从窗口挤出时成为候选者，
+     * 与主缓存的淘汰对象比较 Count-Min Sketch 估算的近期访问频次，候选者更频繁才被接纳，否则直接丢弃。
+     * 主缓存是分段 LRU：新接纳的条目进入试用段（probation），在试用段再次命中后升入保护段（protected，约 80% 主缓存），
+     * 保护段溢出时最久未访问的条目降回试用段；淘汰对象总是优先取自试用段。
+     * 窗口让突发的新热点有机会积累频次，频次过滤挡住扫描与偶发访问，分段 LRU 保留主缓存内部的新近度。
+     *
+     * 条目预先分配在连续的节点池中（与 PoolLRUCache 相同），三条链表以 32 位下标链接，
+     * 每个条目除索引外只有一个池槽位；频次信息全部在约每条目 8 字节的 Sketch 中，不随 Key 保存。
+     * 容量按 Weigher 计量，窗口与保护段的配额同样按权重计算。
+     * 下标为 32 位，条目数上限为 MAX_ENTRIES：按条目计数时容量被截断到该值，
+     * 按其他权重计量时条目数到达上限后写入新条目会先淘汰一个条目。
+     * 线程安全：每次 get / put 都要更新 Sketch 与链表，由一把互斥锁保护。
+     */
+    template<class Key, class Value, class Weigher = UnitWeigher<Key, Value>>
+    class TinyLFUCache : public CachePolicy<Key, Value>
+    {
+        typedef uint32_t Index;
+
+        // 三条链表各有一个哨兵，固定占用池的前 3 个槽位
+        enum Queue : uint8_t { WINDOW = 0, PROBATION = 1, PROTECTED = 2 };
+        static constexpr Index SENTINEL_COUNT = 3;
+        static constexpr Index NO_FREE = 0; // 空闲链表结束标记（哨兵 0 不会被释放）
+
+    public:
+        static constexpr size_t MAX_ENTRIES = std::numeric_limits<Index>::max() - SENTINEL_COUNT; // 哨兵之外的下标都要能放进 Index
+
+    private:
+
+        struct Slot
+        {
+            Key _key;
+            Value _value;
+            size_t _weight;
+            Index _prev;
+            Index _next;
+            Queue _queue;
+
+            Slot() : _key(), _value(), _weight(0), _prev(0), _next(0), _queue(WINDOW) {}
+        };
+
+        struct SlotKeyOf
+        {
+            const std::vector<Slot>* pool;
+            const Key& operator()(Index idx) const { return (*pool)[idx]._key; }
+        };
+        typedef TagIndex<Key, Index, SlotKeyOf> NodeMap;
+
+    private:
+        void unlink(Index idx)
+        {
+            Slot& slot = _pool[idx];
+            _pool[slot._prev]._next = slot._next;
+            _pool[slot._next]._prev = slot._prev;
+            _queueWeight[slot._queue] -= slot._weight;
+        }
+
+        /**
+         * @brief 挂到 queue 的尾部（最近访问端），哨兵的 _next 指向最久未访问
+         */
+        void linkAtTail(Index idx, Queue queue)
+        {
+            Slot& slot = _pool[idx];
+            Slot& sentinel = _pool[queue];
+            slot._queue = queue;
+            slot._prev = sentinel._prev;
+            slot._next = queue;
+            _pool[sentinel._prev]._next = idx;
+            sentinel._prev = idx;
+            _queueWeight[queue] += slot._weight;
+        }
+
+        void moveToTail(Index idx, Queue queue)
+        {
+            unlink(idx);
+            linkAtTail(idx, queue);
+        }
+
+        /**
+         * @brief queue 中最久未访问的条目，队列为空时返回哨兵自身
+         */
+        Index headOf(Queue queue) const { return _pool[queue]._next; }
+
+        Index acquireSlot()
+        {
+            if(_freeHead == NO_FREE)
+            {
+                _pool.emplace_back();
+                return static_cast<Index>(_pool.size() - 1);
+            }
+            Index idx = _freeHead;
+            _freeHead = _pool[idx]._next;
+            return idx;
+        }
+
+        /**
+         * @brief 从所在链表与索引中删除条目，归还槽位（空闲链表复用 _next 字段）
+         */
+        void evict(Index idx)
+        {
+            unlink(idx);
+            _nodeMap.erase(_pool[idx]._key);
+            _usedWeight -= _pool[idx]._weight;
+            _pool[idx]._weight = 0;
+            _pool[idx]._value = Value(); // 及时释放值占用的资源
+            _pool[idx]._next = _freeHead;
+            _freeHead = idx;
+        }
+
+        /**
+         * @brief 命中后调整位置：窗口内移到尾部；试用段升入保护段；保护段移到尾部
+         */
+        void onHit(Index idx)
+        {
+            Queue queue = _pool[idx]._queue;
+            if(queue != PROBATION)
+            {
+                moveToTail(idx, queue);
+                return;
+            }
+            moveToTail(idx, PROTECTED);
+            demoteProtected();
+        }
+
+        /**
+         * @brief 保护段超出配额时，把最久未访问的条目降回试用段
+         */
+        void demoteProtected()
+        {
+            while(_queueWeight[PROTECTED] > _protectedCapacity)
+            {
+                Index oldest = headOf(PROTECTED);
+                if(oldest == PROTECTED || _pool[oldest]._weight == _queueWeight[PROTECTED]) break; // 只剩一个条目时保留
+                moveToTail(oldest, PROBATION);
+            }
+        }
+
+        /**
+         * @brief 主缓存的淘汰对象：优先取试用段最久未访问的条目，试用段为空时取保护段的
+         */
+        Index mainVictim() const
+        {
+            Index victim = headOf(PROBATION);
+            if(victim != PROBATION) return victim;
+            victim = headOf(PROTECTED);
+            return victim != PROTECTED ? victim : NO_FREE;
+        }
+
+        /**
+         * @brief 总权重超出预算时回收：依次淘汰试用段、保护段、窗口最久未访问的条目，跳过刚写入的 keep
+         * 只在已有条目变重时才会发生（主缓存超出自己的配额，之后窗口里的新条目把总量推过预算）。
+         */
+        void enforceCapacity(Index keep)
+        {
+            while(_usedWeight > _capacity)
+            {
+                Index victim = NO_FREE;
+                for(Queue queue : {PROBATION, PROTECTED, WINDOW})
+                {
+                    victim = headOf(queue);
+                    if(victim == keep) victim = _pool[victim]._next;
+                    if(victim != queue) break;
+                    victim = NO_FREE;
+                }
+                if(victim == NO_FREE) return;
+                evict(victim);
+            }
+        }
+
+        /**
+         * @brief 窗口超出配额时，把最久未访问的条目逐个交给准入过滤
+         * 主缓存放得下时直接进入试用段；否则候选者的频次必须严格高于淘汰对象才被接纳（平局时保留老条目，
+         * 扫描带来的新 Key 频次都很低，无法挤掉主缓存），接纳时按需淘汰多个对象以腾出权重。
+         */
+        void evictFromWindow()
+        {
+            while(_queueWeight[WINDOW] > _windowCapacity)
+            {
+                Index candidate = headOf(WINDOW);
+                if(_pool[candidate]._weight > _mainCapacity)
+                {
+                    evict(candidate);
+                    continue;
+                }
+
+                unsigned candidateFreq = _sketch.frequency(_nodeMap.hashOf(_pool[candidate]._key));
+                bool admitted = true;
+                while(_queueWeight[PROBATION] + _queueWeight[PROTECTED] + _pool[candidate]._weight > _mainCapacity)
+                {
+                    Index victim = mainVictim();
+                    if(candidateFreq <= _sketch.frequency(_nodeMap.hashOf(_pool[victim]._key)))
+                    {
+                        admitted = false;
+                        break;
+                    }
+                    evict(victim);
+                }
+
+                if(admitted) moveToTail(candidate, PROBATION);
+                else evict(candidate);
+            }
+        }
+
+    public:
+        /**
+         * @brief 初始化缓存
+         * 窗口占容量的 1%（至少 1），其余为主缓存，其中 80% 为保护段。
+         * 按条目计数时一次性分配 capacity 个槽位；Sketch 按预期条目数分配。
+         * @param capacity 缓存容量上限（所有条目权重之和的上限）；按条目计数时超过 MAX_ENTRIES 的部分被截断
+         * @param weigher 权重函数，默认每个条目计 1
+         * @param expectedEntries 预期条目数，决定 Sketch 大小；为 0 时取 capacity（按条目计数时即条目数）
+         */
+        TinyLFUCache(size_t capacity, Weigher weigher = Weigher(), size_t expectedEntries = 0)
+            : _capacity(std::is_same<Weigher, UnitWeigher<Key, Value>>::value ? std::min(capacity, MAX_ENTRIES) : capacity),
+              _windowCapacity(_capacity > 1 ? std::max<size_t>(1, _capacity / 100) : _capacity),
+              _mainCapacity(_capacity - _windowCapacity),
+              _protectedCapacity(_mainCapacity * 4 / 5),
+              _usedWeight(0),
+              _queueWeight{0, 0, 0},
+              _weigher(weigher),
+              _freeHead(NO_FREE),
+              _nodeMap(SlotKeyOf{&_pool}),
+              _sketch(expectedEntries > 0 ? expectedEntries : _capacity)
+        {
+            _pool.resize(SENTINEL_COUNT);
+            for(Index q = 0; q < SENTINEL_COUNT; ++q)
+            {
+                _pool[q]._prev = q;
+                _pool[q]._next = q;
+            }
+            if(std::is_same<Weigher, UnitWeigher<Key, Value>>::value)
+            {
+                _pool.resize(SENTINEL_COUNT + _capacity);
+                _nodeMap.reserve(_capacity);
+                // 串起空闲链表：3 -> 4 -> ... -> capacity + 2 -> NO_FREE
+                for(size_t i = SENTINEL_COUNT + _capacity; i-- > SENTINEL_COUNT; )
+                {
+                    _pool[i]._next = _freeHead;
+                    _freeHead = static_cast<Index>(i);
+                }
+            }
+        }
+
+        ~TinyLFUCache() override = default;
+
+        void put(const Key& key, const Value& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), value);
+        }
+
+        void put(const Key& key, Value&& value) override
+        {
+            putImpl(key, _nodeMap.hashOf(key), std::move(value));
+        }
+
+        bool get(const Key& key, Value& value) override
+        {
+            return visit(key, [&value](const Value& stored) { value = stored; });
+        }
+
+        Value get(const Key& key) override
+        {
+            Value value{};
+            get(key, value);
+            return value;
+        }
+
+        /**
+         * @brief 免拷贝读取：命中时在锁内以 const 引用调用 fn(value)
+         * 无论是否命中都计入 Sketch。fn 中不能再访问本缓存，否则会死锁。
+         * @return 是否命中
+         */
+        template<class Fn>
+        bool visit(const Key& key, Fn&& fn)
+        {
+            return visitWithHash(key, _nodeMap.hashOf(key), std::forward<Fn>(fn));
+        }
+
+        /**
+         * @brief 带预先算好哈希的读写接口，供分片路由复用同一个哈希值（索引与 Sketch 都使用它）
+         * hash 必须等于 cacheHashOf<Key>(key)，否则查找结果未定义
+         */
+        bool getWithHash(const Key& key, uint64_t hash, Value& value)
+        {
+            return visitWithHash(key, hash, [&value](const Value& stored) { value = stored; });
+        }
+
+        template<class Fn>
+        bool visitWithHash(const Key& key, uint64_t hash, Fn&& fn)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _sketch.increment(hash);
+            auto it = _nodeMap.find(key, hash);
+            if(it == _nodeMap.end()) return false;
+            Index idx = it->mapped;
+            onHit(idx);
+            fn(static_cast<const Value&>(_pool[idx]._value));
+            return true;
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, const Value& value)
+        {
+            putImpl(key, hash, value);
+        }
+
+        void putWithHash(const Key& key, uint64_t hash, Value&& value)
+        {
+            putImpl(key, hash, std::move(value));
+        }
+
+        /**
+         * @brief 判断 Key 是否在缓存中（不计频次、不调整位置）
+         */
+        bool contains(const Key& key)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _nodeMap.find(key) != _nodeMap.end();
+        }
+
+        /**
+         * @brief 手动删除指定 Key 的缓存项（Sketch 中的频次保留，随老化自然衰减）
+         */
+        void remove(const Key& key)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _nodeMap.find(key);
+            if(it != _nodeMap.end()) evict(it->mapped);
+        }
+
+        /**
+         * @brief 当前已占用的权重总和
+         */
+        size_t usedWeight()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _usedWeight;
+        }
+
+    private:
+        /**
+         * @brief 写入逻辑：两个 put 重载共用，value 按原本的值类别转发（左值拷贝、右值移动）
+         * 新 Key 总是先进入窗口，是否留在缓存中由它被挤出窗口时的准入过滤决定。
+         */
+        template<class V>
+        void putImpl(const Key& key, uint64_t h, V&& value)
+        {
+            if(_capacity == 0) return;
+            size_t weight = _weigher(key, value);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _sketch.increment(h);
+            auto it = _nodeMap.find(key, h);
+            if(weight > _capacity)
+            {
+                // 单个条目超过整个预算，无法存放：拒绝写入，同时丢弃旧值避免读到过期数据
+                if(it != _nodeMap.end()) evict(it->mapped);
+                return;
+            }
+            if(it != _nodeMap.end())
+            {
+                Index idx = it->mapped;
+                Slot& slot = _pool[idx];
+                slot._value = std::forward<V>(value);
+                _queueWeight[slot._queue] = _queueWeight[slot._queue] - slot._weight + weight;
+                _usedWeight = _usedWeight - slot._weight + weight;
+                slot._weight = weight;
+                onHit(idx);
+                if(slot._queue == WINDOW) evictFromWindow();
+                enforceCapacity(idx);
+                return;
+            }
+
+            // 条目数到达下标上限时先腾出一个槽位（只在按其他权重计量时可能发生）
+            while(_nodeMap.size() >= MAX_ENTRIES)
+            {
+                Index victim = mainVictim();
+                evict(victim != NO_FREE ? victim : headOf(WINDOW));
+            }
+
+            Index idx = acquireSlot();
+            _pool[idx]._key = key;
+            _pool[idx]._value = std::forward<V>(value);
+            _pool[idx]._weight = weight;
+            _usedWeight += weight;
+            linkAtTail(idx, WINDOW);
+            _nodeMap.insert(idx, h);
+            evictFromWindow();
+            enforceCapacity(idx);
+        }
+
+    private:
+        size_t _capacity;           // 缓存最大容量（权重预算）
+        size_t _windowCapacity;     // 窗口 LRU 的配额
+        size_t _mainCapacity;       // 主缓存（试用段 + 保护段）的配额
+        size_t _protectedCapacity;  // 保护段的配额
+        size_t _usedWeight;         // 当前已占用的权重
+        size_t _queueWeight[3];     // 三条链表各自占用的权重
+        Weigher _weigher;           // 条目权重函数
+        std::vector<Slot> _pool;    // 连续节点池，下标 0～2 为三条链表的哨兵
+        Index _freeHead;            // 空闲槽位链表头，NO_FREE 表示没有空闲槽位
+        NodeMap _nodeMap;           // 标签分组索引：Key -> 池下标
+        FrequencySketch _sketch;    // 近期访问频次估算
+        std::mutex _mutex;          // 互斥锁，支持多线程安全
+    };
+}
+
+#endif
@@ -1,12 +1,25 @@
 #include "LRU/LRU.hpp"
 #include "LRU/LRUK.hpp"
 #include "LRU/HashLRU.hpp"
+#include "LRU/PoolLRU.hpp"
+#include "LRU/HashClockCache.hpp"
+#include "LRU/ConcurrentLRUCache.hpp"
+#include "ARC/ConcurrentArcCache.hpp"
 #include "LFU/HashLFUCache.hpp"
 #include "LFU/LFUCache.hpp"
 #include "FIFO/FIFOCache.hpp"
+#include "FIFO/HashS3FIFOCache.hpp"
 #include "ARC/ArcCache.hpp"
+#include "ARC/HashArcCache.hpp"
+#include "TinyLFU/TinyLFUCache.hpp"
+#include "Common/LoadingCache.hpp"
 #include <random>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
 #include <array>
+#include <chrono>
+#include <thread>
 
 /**
  * @brief 结果打印辅助函数
@@ -17,7 +30,8 @@ void printResults(const std::string &testName, int capacity, const std::vector<i
     std::cout << "=== " << testName << " ===" << std::endl;
     std::cout << "缓存容量：" << capacity << std::endl;
     for (size_t i = 0; i < hits.size(); ++i) {
-        std::string algoName = (i == 0 ? "LRU" : (i == 1 ? "LFU" : "ARC"));
+        const char *algoNames[] = {"LRU", "LFU", "ARC", "TinyLFU", "S3-FIFO"};
+        std::string algoName = algoNames[i];
         double rate = (get_operations[i] > 0) ? ((double)hits[i] / get_operations[i]) * 100 : 0;
         std::cout << algoName << " - 命中率：" << rate << "%" 
                   << " (" << hits[i] << "/" << get_operations[i] << ")" << std::endl;
@@ -42,13 +56,15 @@ void testHotDataAccess()
     myCache::LFUCache<int, std::string> lfu(CAPACITY);
     // 注意：ARC内部包含LRU和LFU两部分，这里传入CAPACITY/2可能导致总容量与前两者不完全一致，视实现而定
     myCache::ArcCache<int, std::string> arc(CAPACITY / 2);
+    myCache::TinyLFUCache<int, std::string> tinyLfu(CAPACITY);
+    myCache::S3FIFOCache<int, std::string> s3fifo(CAPACITY);
 
     std::random_device rd;
     std::mt19937 gen(rd()); //随机数
 
-    std::array<myCache::CachePolicy<int, std::string> *, 3> caches = {&lru, &lfu, &arc};
-    std::vector<int> hits(3, 0);           
-    std::vector<int> get_operations(3, 0); 
+    std::array<myCache::CachePolicy<int, std::string> *, 5> caches = {&lru, &lfu, &arc, &tinyLfu, &s3fifo};
+    std::vector<int> hits(5, 0);           
+    std::vector<int> get_operations(5, 0); 
 
     for (int i = 0; i < caches.size(); ++i)
     {
@@ -95,10 +111,12 @@ void testLoopPattern()
     myCache::LRUCache<int, std::string> lru(CAPACITY);
     myCache::LFUCache<int, std::string> lfu(CAPACITY);
     myCache::ArcCache<int, std::string> arc(CAPACITY / 2);
+    myCache::TinyLFUCache<int, std::string> tinyLfu(CAPACITY);
+    myCache::S3FIFOCache<int, std::string> s3fifo(CAPACITY);
 
-    std::array<myCache::CachePolicy<int, std::string> *, 3> caches = {&lru, &lfu, &arc};
-    std::vector<int> hits(3, 0);
-    std::vector<int> get_operations(3, 0);
+    std::array<myCache::CachePolicy<int, std::string> *, 5> caches = {&lru, &lfu, &arc, &tinyLfu, &s3fifo};
+    std::vector<int> hits(5, 0);
+    std::vector<int> get_operations(5, 0);
 
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -146,12 +164,14 @@ void testWorkloadShift()
     myCache::LRUCache<int, std::string> lru(CAPACITY);
     myCache::LFUCache<int, std::string> lfu(CAPACITY);
     myCache::ArcCache<int, std::string> arc(CAPACITY / 2);
+    myCache::TinyLFUCache<int, std::string> tinyLfu(CAPACITY);
+    myCache::S3FIFOCache<int, std::string> s3fifo(CAPACITY);
 
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::array<myCache::CachePolicy<int, std::string> *, 3> caches = {&lru, &lfu, &arc};
-    std::vector<int> hits(3, 0);
-    std::vector<int> get_operations(3, 0);
+    std::array<myCache::CachePolicy<int, std::string> *, 5> caches = {&lru, &lfu, &arc, &tinyLfu, &s3fifo};
+    std::vector<int> hits(5, 0);
+    std::vector<int> get_operations(5, 0);
 
     for (int i = 0; i < caches.size(); ++i)
     {
@@ -189,10 +209,608 @@ void testWorkloadShift()
     printResults("工作负载剧烈变化测试", CAPACITY, get_operations, hits);
 }
 
+/**
+ * @brief 场景4：单分片吞吐量测试
+ * 对比 LRUCache（shared_ptr 节点）、PoolLRUCache（连续节点池 + 下标链接）与 LFUCache 每秒可完成的 get/put 次数。
+ * 第二组容量远大于末级缓存（LLC），此时每次查找的缓存未命中次数决定吞吐量。
+ */
+void testLruThroughput()
+{
+    std::cout << "\n=== 测试场景4：单分片吞吐量测试 ===" << std::endl;
+
+    const int OPERATIONS = 2000000;
+
+    for (int capacity : {10000, 2000000})
+    {
+        const int KEY_RANGE = capacity * 2;
+
+        myCache::LRUCache<int, int> lru(capacity);
+        myCache::PoolLRUCache<int, int> poolLru(capacity);
+        myCache::LFUCache<int, int> lfu(capacity);
+
+        std::array<myCache::CachePolicy<int, int> *, 3> caches = {&lru, &poolLru, &lfu};
+        std::array<const char *, 3> names = {"LRU", "PoolLRU", "LFU"};
+
+        // 预先生成访问序列，避免随机数生成本身计入耗时
+        std::mt19937 gen(42);
+        std::vector<int> keys(OPERATIONS);
+        for (int &key : keys) key = gen() % KEY_RANGE;
+
+        std::cout << "缓存容量：" << capacity << std::endl;
+        for (size_t i = 0; i < caches.size(); ++i)
+        {
+            // 先填满缓存，使测量阶段的查找落在完整规模的索引上
+            for (int key = 0; key < capacity; ++key) caches[i]->put(key, key);
+
+            int hits = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int op = 0; op < OPERATIONS; ++op)
+            {
+                int value;
+                if (op % 4 == 0) caches[i]->put(keys[op], op); // 25% 写，75% 读
+                else if (caches[i]->get(keys[op], value)) hits++;
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << names[i] << " - 吞吐量：" << static_cast<long long>(OPERATIONS / elapsed.count())
+                      << " ops/s (命中 " << hits << ")" << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief 场景5：ARC 的 LFU 部分（T2）命中延迟测试
+ * 被命中的热点 Key 固定为 HOT_SETS 组、每组 HOT_KEYS 个，只有各频率桶里“陪跑”的冷条目数随规模增长：
+ * 频率 1～ROUNDS + 1 的每个桶都预先填入 padding 个从不访问的冷条目，热点 Key 每轮命中从频率 f 的桶移到 f + 1 的桶，
+ * 每次移动的源桶与目标桶都含有 padding 个冷条目。热点 Key 占用的内存与规模无关，
+ * 表中条目总数随规模增长，热点 Key 在索引中的槽位随之分散，索引查找本身会变慢；
+ * 因此先用只查索引的 contain 走一遍同样的顺序，命中耗时减去它即为升频（桶间移动）的耗时，O(1) 的升频应当保持平稳。
+ */
+void testArcLfuHitLatency()
+{
+    std::cout << "\n=== 测试场景5：ARC-T2 命中延迟测试 ===" << std::endl;
+
+    const int HOT_KEYS = 1000;
+    const int HOT_SETS = 5;
+    const int ROUNDS = 4;
+    std::mt19937 gen(42);
+
+    for (int padding : {1000, 10000, 100000})
+    {
+        const int coldTotal = padding * (ROUNDS + 1);
+        myCache::ArcLfuPart<int, int> t2(coldTotal + HOT_KEYS * HOT_SETS, 2);
+
+        // 冷条目：第 f 组访问 f - 1 次后停在频率 f 的桶中
+        int value;
+        for (int level = 0; level <= ROUNDS; ++level)
+        {
+            for (int i = 0; i < padding; ++i)
+            {
+                int key = level * padding + i;
+                t2.put(key, key);
+                for (int hit = 0; hit < level; ++hit) t2.get(key, value);
+            }
+        }
+
+        // 热点 Key：最后写入，与冷条目一起从频率 1 的桶出发
+        std::vector<int> hotKeys(HOT_KEYS * HOT_SETS);
+        for (int i = 0; i < HOT_KEYS * HOT_SETS; ++i)
+        {
+            hotKeys[i] = coldTotal + i;
+            t2.put(hotKeys[i], hotKeys[i]);
+        }
+
+        // 每组热点 Key 各命中 ROUNDS 轮，每轮顺序打乱
+        std::vector<int> order;
+        for (int set = 0; set < HOT_SETS; ++set)
+        {
+            for (int round = 0; round < ROUNDS; ++round)
+            {
+                std::vector<int> keys(hotKeys.begin() + set * HOT_KEYS, hotKeys.begin() + (set + 1) * HOT_KEYS);
+                std::shuffle(keys.begin(), keys.end(), gen);
+                order.insert(order.end(), keys.begin(), keys.end());
+            }
+        }
+
+        int found = 0;
+        auto lookupStart = std::chrono::steady_clock::now();
+        for (int key : order)
+        {
+            found += t2.contain(key);
+        }
+        std::chrono::duration<double, std::nano> lookup = std::chrono::steady_clock::now() - lookupStart;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int key : order)
+        {
+            found += t2.get(key, value);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        double hitNs = elapsed.count() / order.size();
+        double lookupNs = lookup.count() / order.size();
+        std::cout << "每桶冷条目 " << padding << " - 平均命中耗时：" << hitNs << " ns（索引查找 " << lookupNs
+                  << " ns，升频 " << hitNs - lookupNs << " ns）" << (found < 0 ? " " : "") << std::endl;
+    }
+}
+
+/**
+ * @brief 多线程读多写少吞吐量测试的单次运行
+ * 每个线程按 95% 读、5% 写访问同一个分片缓存，返回总吞吐量（ops/s）
+ */
+template <class Cache>
+double runReadHeavy(Cache &cache, int threadNum, int opsPerThread, int keyRange)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threadNum; ++t)
+    {
+        workers.emplace_back([&cache, t, opsPerThread, keyRange]()
+        {
+            std::mt19937 gen(t);
+            int value;
+            for (int op = 0; op < opsPerThread; ++op)
+            {
+                int key = gen() % keyRange;
+                if (op % 20 == 0) cache.put(key, op);
+                else cache.get(key, value);
+            }
+        });
+    }
+    for (auto &worker : workers) worker.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return threadNum * static_cast<double>(opsPerThread) / elapsed.count();
+}
+
+/**
+ * @brief 场景6：多线程读多写少吞吐量测试
+ * HashLRUCache 的每次命中都要在分片锁内调整链表；开启读缓冲后命中只在共享锁下记录访问，链表调整攒批回放；
+ * HashClockCache 的命中不取锁，只原子地置引用位；HashS3FIFOCache 的命中同样只在共享锁下增加频次；
+ * HashArcCache 的每个分片由一把锁保护全部四个列表。
+ * 分片数固定，线程数逐步增加，观察吞吐量随线程数的变化。
+ */
+void testReadHeavyScaling()
+{
+    std::cout << "\n=== 测试场景6：多线程读多写少吞吐量测试 ===" << std::endl;
+
+    const int CAPACITY = 100000;
+    const int KEY_RANGE = 120000;
+    const int SLICES = 8;
+    const int OPS_PER_THREAD = 500000;
+
+    for (int threadNum : {1, 2, 4, 8})
+    {
+        myCache::HashLRUCache<int, int> lru(CAPACITY, SLICES);
+        myCache::HashLRUCache<int, int> bufferedLru(CAPACITY, SLICES, myCache::UnitWeigher<int, int>(), true);
+        myCache::HashClockCache<int, int> clock(CAPACITY, SLICES);
+        myCache::HashArcCache<int, int> arc(CAPACITY, SLICES);
+        myCache::HashS3FIFOCache<int, int> s3fifo(CAPACITY, SLICES);
+        for (int key = 0; key < CAPACITY; ++key)
+        {
+            lru.put(key, key);
+            bufferedLru.put(key, key);
+            clock.put(key, key);
+            arc.put(key, key);
+            s3fifo.put(key, key);
+        }
+
+        double lruOps = runReadHeavy(lru, threadNum, OPS_PER_THREAD, KEY_RANGE);
+        double bufferedOps = runReadHeavy(bufferedLru, threadNum, OPS_PER_THREAD, KEY_RANGE);
+        double clockOps = runReadHeavy(clock, threadNum, OPS_PER_THREAD, KEY_RANGE);
+        double arcOps = runReadHeavy(arc, threadNum, OPS_PER_THREAD, KEY_RANGE);
+        double s3fifoOps = runReadHeavy(s3fifo, threadNum, OPS_PER_THREAD, KEY_RANGE);
+        std::cout << threadNum << " 线程 - HashLRU：" << static_cast<long long>(lruOps)
+                  << " ops/s，HashLRU(读缓冲)：" << static_cast<long long>(bufferedOps)
+                  << " ops/s，HashClock：" << static_cast<long long>(clockOps)
+                  << " ops/s，HashArc：" << static_cast<long long>(arcOps)
+                  << " ops/s，HashS3FIFO：" << static_cast<long long>(s3fifoOps) << " ops/s" << std::endl;
+    }
+}
+
+/**
+ * @brief 场景7：读路径无锁缓存的扩展性测试
+ * HashLRUCache / HashArcCache 的每次读取都要获取所在分片的锁；HashConcurrentLRUCache / HashConcurrentArcCache
+ * 的读取不取任何锁，只在纪元槽位上登记并记入读缓冲，链表调整攒批回放。
+ * 四者分片数相同，淘汰策略相同，差别只在读路径，曲线反映的是读路径本身而不是单把写锁。
+ * 总操作数固定，线程数从 1 增加到 64，观察吞吐量随线程数的变化。
+ */
+void testConcurrentScaling()
+{
+    std::cout << "\n=== 测试场景7：读路径无锁缓存扩展性测试 ===" << std::endl;
+
+    const int CAPACITY = 100000;
+    const int KEY_RANGE = 120000;
+    const int SLICES = 8;
+    const int TOTAL_OPS = 4000000;
+
+    for (int threadNum : {1, 2, 4, 8, 16, 32, 64})
+    {
+        myCache::HashLRUCache<int, int> lru(CAPACITY, SLICES);
+        myCache::HashConcurrentLRUCache<int, int> concurrentLru(CAPACITY, SLICES);
+        myCache::HashArcCache<int, int> arc(CAPACITY, SLICES);
+        myCache::HashConcurrentArcCache<int, int> concurrentArc(CAPACITY, SLICES);
+        for (int key = 0; key < CAPACITY; ++key)
+        {
+            lru.put(key, key);
+            concurrentLru.put(key, key);
+            arc.put(key, key);
+            concurrentArc.put(key, key);
+        }
+
+        double lruOps = runReadHeavy(lru, threadNum, TOTAL_OPS / threadNum, KEY_RANGE);
+        double concurrentLruOps = runReadHeavy(concurrentLru, threadNum, TOTAL_OPS / threadNum, KEY_RANGE);
+        double arcOps = runReadHeavy(arc, threadNum, TOTAL_OPS / threadNum, KEY_RANGE);
+        double concurrentArcOps = runReadHeavy(concurrentArc, threadNum, TOTAL_OPS / threadNum, KEY_RANGE);
+        std::cout << threadNum << " 线程 - HashLRU：" << static_cast<long long>(lruOps)
+                  << " ops/s，HashConcurrentLRU：" << static_cast<long long>(concurrentLruOps)
+                  << " ops/s，HashArc：" << static_cast<long long>(arcOps)
+                  << " ops/s，HashConcurrentArc：" << static_cast<long long>(concurrentArcOps) << " ops/s" << std::endl;
+    }
+}
+
+/**
+ * @brief 场景8的对照用分片缓存：与 HashLRUCache 相同的路由方式，分片布局由 Padded 决定
+ * 对齐与紧凑两种布局走完全相同的代码路径，吞吐量的差别只来自相邻分片是否共享缓存行。
+ */
+template <class Shard, bool Padded>
+class ShardLayoutCache
+{
+public:
+    ShardLayoutCache(size_t capacity, int sliceNum)
+        : _router(sliceNum), _shards(_router.shardCount(), _router.perShard(capacity))
+    {}
+
+    void put(int key, int value)
+    {
+        uint64_t hash = myCache::cacheHashOf<int>(key);
+        _shards[_router.shardOf(hash)].putWithHash(key, hash, value);
+    }
+
+    bool get(int key, int &value)
+    {
+        uint64_t hash = myCache::cacheHashOf<int>(key);
+        return _shards[_router.shardOf(hash)].getWithHash(key, hash, value);
+    }
+
+private:
+    myCache::ShardRouter _router;
+    myCache::ShardArray<Shard, Padded> _shards;
+};
+
+/**
+ * @brief 场景8的单次运行：线程 t 只访问落在分片 t 上的 Key
+ * 线程之间没有任何锁竞争，吞吐量随线程数的变化只取决于相邻分片之间是否共享缓存行。
+ */
+template <class Cache>
+double runShardLocal(Cache &cache, const std::vector<std::vector<int>> &shardKeys, int opsPerThread)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < shardKeys.size(); ++t)
+    {
+        workers.emplace_back([&cache, &keys = shardKeys[t], opsPerThread]()
+        {
+            int value;
+            for (int op = 0; op < opsPerThread; ++op)
+            {
+                int key = keys[op % keys.size()];
+                if (op % 20 == 0) cache.put(key, op);
+                else cache.get(key, value);
+            }
+        });
+    }
+    for (auto &worker : workers) worker.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return shardKeys.size() * static_cast<double>(opsPerThread) / elapsed.count();
+}
+
+/**
+ * @brief 场景8：分片伪共享测试
+ * 分片数等于线程数，每个线程只访问自己分片上的少量 Key。
+ * 分片连续存放、按缓存行对齐，各分片的锁与计数器互不共享缓存行，吞吐量应随线程数（不超过核心数时）线性增长。
+ * LRU / LFU 分片的锁（CacheMutex）自身按缓存行对齐，分片数组是否填充对它们没有影响；
+ * TinyLFU 分片内部没有对齐的成员，因此用它分别以对齐布局和紧凑布局（分片之间不留填充）跑同样的负载，
+ * 两者之差就是分片数组的对齐消除的伪共享开销。
+ */
+void testShardFalseSharing()
+{
+    std::cout << "\n=== 测试场景8：分片伪共享测试 ===" << std::endl;
+
+    const size_t KEYS_PER_SHARD = 64;
+    const int OPS_PER_THREAD = 1000000;
+
+    for (int threadNum : {1, 2, 4, 8, 16, 32, 64})
+    {
+        // 按分片路由挑出每个分片各自的 Key，线程 t 只访问分片 t
+        myCache::ShardRouter router(threadNum);
+        std::vector<std::vector<int>> shardKeys(router.shardCount());
+        size_t filled = 0;
+        for (int key = 0; filled < shardKeys.size(); ++key)
+        {
+            std::vector<int> &keys = shardKeys[router.shardOf(myCache::cacheHashOf<int>(key))];
+            if (keys.size() == KEYS_PER_SHARD) continue;
+            keys.push_back(key);
+            if (keys.size() == KEYS_PER_SHARD) ++filled;
+        }
+
+        myCache::HashLRUCache<int, int> lru(KEYS_PER_SHARD * threadNum, threadNum);
+        myCache::HashLFUCache<int, int> lfu(KEYS_PER_SHARD * threadNum, threadNum);
+        ShardLayoutCache<myCache::TinyLFUCache<int, int>, true> padded(KEYS_PER_SHARD * threadNum, threadNum);
+        ShardLayoutCache<myCache::TinyLFUCache<int, int>, false> packed(KEYS_PER_SHARD * threadNum, threadNum);
+        for (const auto &keys : shardKeys)
+        {
+            for (int key : keys)
+            {
+                lru.put(key, key);
+                lfu.put(key, key);
+                padded.put(key, key);
+                packed.put(key, key);
+            }
+        }
+
+        double lruOps = runShardLocal(lru, shardKeys, OPS_PER_THREAD);
+        double lfuOps = runShardLocal(lfu, shardKeys, OPS_PER_THREAD);
+        double paddedOps = runShardLocal(padded, shardKeys, OPS_PER_THREAD);
+        double packedOps = runShardLocal(packed, shardKeys, OPS_PER_THREAD);
+        std::cout << threadNum << " 线程 - HashLRU：" << static_cast<long long>(lruOps)
+                  << " ops/s，HashLFU：" << static_cast<long long>(lfuOps)
+                  << " ops/s，TinyLFU 对齐分片：" << static_cast<long long>(paddedOps)
+                  << " ops/s，TinyLFU 紧凑分片：" << static_cast<long long>(packedOps) << " ops/s" << std::endl;
+    }
+}
+
+/**
+ * @brief 场景9的单次运行：随机访问 keys，未命中时写入，返回后半段的命中率
+ */
+template <class Cache>
+double runMissThenPut(Cache &cache, const std::vector<int> &keys, int operations)
+{
+    std::mt19937 gen(42);
+    int value;
+    int hits = 0;
+    for (int op = 0; op < operations; ++op)
+    {
+        int key = keys[gen() % keys.size()];
+        bool hit = cache.get(key, value);
+        if (!hit) cache.put(key, key);
+        if (op >= operations / 2 && hit) ++hits;
+    }
+    return 100.0 * hits / (operations - operations / 2);
+}
+
+/**
+ * @brief 场景9：分片容量再分配测试
+ * 总工作集小于总容量，但一半以上的 Key 落在同一个分片：固定均分时这个分片装不下自己的工作集而反复淘汰，
+ * 其余分片却空着一半。开启 adaptiveCapacity 后配额按未命中压力流向热分片，命中率接近不分片的缓存。
+ */
+void testShardRebalance()
+{
+    std::cout << "\n=== 测试场景9：分片容量再分配测试 ===" << std::endl;
+
+    const int CAPACITY = 8000;
+    const int SLICES = 8;
+    const int OPERATIONS = 2000000;
+
+    // 分片 0 分到 4000 个 Key，其余分片各 500 个，合计 7500 个
+    myCache::ShardRouter router(SLICES);
+    std::vector<std::vector<int>> shardKeys(router.shardCount());
+    std::vector<size_t> quota(router.shardCount(), 500);
+    quota[0] = 4000;
+    size_t filled = 0;
+    for (int key = 0; filled < shardKeys.size(); ++key)
+    {
+        size_t shard = router.shardOf(myCache::cacheHashOf<int>(key));
+        if (shardKeys[shard].size() == quota[shard]) continue;
+        shardKeys[shard].push_back(key);
+        if (shardKeys[shard].size() == quota[shard]) ++filled;
+    }
+    std::vector<int> keys;
+    for (const auto &shard : shardKeys) keys.insert(keys.end(), shard.begin(), shard.end());
+
+    myCache::LRUCache<int, int> single(CAPACITY);
+    myCache::HashLRUCache<int, int> fixed(CAPACITY, SLICES);
+    myCache::HashLRUCache<int, int> adaptive(CAPACITY, SLICES, myCache::UnitWeigher<int, int>(), false, true);
+    std::cout << "LRU(不分片) - 命中率：" << runMissThenPut(single, keys, OPERATIONS) << "%" << std::endl;
+    std::cout << "HashLRU(均分) - 命中率：" << runMissThenPut(fixed, keys, OPERATIONS) << "%" << std::endl;
+    std::cout << "HashLRU(再分配) - 命中率：" << runMissThenPut(adaptive, keys, OPERATIONS) << "%" << std::endl;
+}
+
+/**
+ * @brief 场景10的单次运行：按 batch 个 Key 一组依次读取 keys，返回每个 Key 的平均耗时（纳秒）
+ * batch 为 1 时逐个调用 get，否则调用 multiGet。
+ */
+template <class Cache>
+double runBatchGet(Cache &cache, const std::vector<int> &keys, size_t batch)
+{
+    std::vector<int> values(batch);
+    std::unique_ptr<bool[]> found(new bool[batch]);
+    long long hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset + batch <= keys.size(); offset += batch)
+    {
+        if (batch == 1)
+        {
+            hits += cache.get(keys[offset], values[0]);
+            continue;
+        }
+        cache.multiGet(&keys[offset], batch, values.data(), found.get());
+        for (size_t i = 0; i < batch; ++i) hits += found[i];
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    if (hits < 0) std::cout << hits; // 防止结果被优化掉
+    return elapsed.count() / (keys.size() / batch * batch);
+}
+
+/**
+ * @brief 场景10：批量读取测试
+ * 缓存条目远多于 CPU 缓存能装下的数量，随机 Key 的索引探测基本都是缓存未命中。
+ * multiGet 先算好全部哈希、按分片分组、每个分片只加一次锁，并在探测前提前预取后面 Key 的索引槽位，
+ * 多个 Key 的内存访问得以重叠；条目能装进 CPU 缓存时两者耗时接近。
+ */
+void testBatchGet()
+{
+    std::cout << "\n=== 测试场景10：批量读取测试 ===" << std::endl;
+
+    const int ENTRIES = 1000000;
+    const size_t BATCH = 100;
+    const int LOOKUPS = 2000000;
+
+    std::mt19937 gen(42);
+    std::vector<int> keys(LOOKUPS);
+    for (int &key : keys) key = gen() % (ENTRIES + ENTRIES / 10); // 约 9% 的 Key 不存在
+
+    myCache::LRUCache<int, int> lru(ENTRIES);
+    myCache::LFUCache<int, int> lfu(ENTRIES);
+    myCache::HashLRUCache<int, int> hashLru(ENTRIES, 8);
+    myCache::HashLFUCache<int, int> hashLfu(ENTRIES, 8);
+    for (int key = 0; key < ENTRIES; ++key)
+    {
+        lru.put(key, key);
+        lfu.put(key, key);
+        hashLru.put(key, key);
+        hashLfu.put(key, key);
+    }
+
+    auto report = [&keys, BATCH](const char *name, auto &cache)
+    {
+        double single = runBatchGet(cache, keys, 1);
+        double batched = runBatchGet(cache, keys, BATCH);
+        std::cout << name << " - 逐个 get：" << single << " ns/key，multiGet(" << BATCH << ")："
+                  << batched << " ns/key" << std::endl;
+    };
+    report("LRU", lru);
+    report("LFU", lfu);
+    report("HashLRU", hashLru);
+    report("HashLFU", hashLfu);
+}
+
+/**
+ * @brief 场景11的单次运行：threadNum 个线程同时请求同一批冷 Key，返回 loader 被调用的次数
+ * useLoading 为 false 时每个线程各自 get、未命中则加载并 put；为 true 时通过 getOrLoad 合并回源。
+ */
+template <class Loading>
+int runStampede(Loading &loading, int threadNum, int keyCount, bool useLoading)
+{
+    std::atomic<int> loads{0};
+    auto loader = [&loads](const int &key)
+    {
+        ++loads;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2)); // 模拟后端访问延迟
+        return std::to_string(key);
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadNum; ++t)
+    {
+        workers.emplace_back([&loading, &loader, keyCount, useLoading]()
+        {
+            for (int key = 0; key < keyCount; ++key)
+            {
+                if (useLoading)
+                {
+                    loading.getOrLoad(key, loader);
+                    continue;
+                }
+                std::string value;
+                if (!loading.cache().get(key, value)) loading.cache().put(key, loader(key));
+            }
+        });
+    }
+    for (auto &worker : workers) worker.join();
+    return loads.load();
+}
+
+/**
+ * @brief 场景11：缓存击穿测试
+ * 多个线程同时请求同一批尚未缓存的 Key（热点 Key 刚失效时的情形）。
+ * 直接 get + put 时每个未命中的线程都会回源；getOrLoad 把同一 Key 的并发未命中合并为一次加载。
+ */
+void testLoadStampede()
+{
+    std::cout << "\n=== 测试场景11：缓存击穿测试 ===" << std::endl;
+
+    const int THREADS = 16;
+    const int KEYS = 50;
+
+    for (bool useLoading : {false, true})
+    {
+        myCache::LRUCache<int, std::string> lru(KEYS);
+        myCache::ArcCache<int, std::string> arc(KEYS);
+        myCache::LoadingCache<int, std::string> lruLoading(lru);
+        myCache::LoadingCache<int, std::string> arcLoading(arc);
+        std::cout << (useLoading ? "getOrLoad" : "get + put") << " - " << THREADS << " 线程 × " << KEYS
+                  << " 个冷 Key，LRU 回源：" << runStampede(lruLoading, THREADS, KEYS, useLoading)
+                  << " 次，ARC 回源：" << runStampede(arcLoading, THREADS, KEYS, useLoading) << " 次" << std::endl;
+    }
+}
+
+/**
+ * @brief 场景12：扫描 + Zipf 混合测试
+ * 大部分时间按 Zipf 分布访问 10 万个 Key（少数 Key 占大部分访问），每隔一段插入一轮从未出现过的顺序扫描。
+ * 未命中时写入。LRU 会被扫描冲掉热点；W-TinyLFU 的频次过滤让只出现一次的扫描 Key 进不了主缓存，
+ * 同时窗口与 Sketch 老化让它跟得上 Zipf 尾部的变化。
+ */
+void testScanZipf()
+{
+    std::cout << "\n=== 测试场景12：扫描 + Zipf 混合测试 ===" << std::endl;
+
+    const int CAPACITY = 1000;
+    const int KEY_SPACE = 100000;
+    const int OPERATIONS = 1000000;
+    const int SEGMENT = 5000; // 每 4 段中有 1 段是顺序扫描
+
+    // Zipf(0.9) 的累积分布，按二分查找抽样
+    std::vector<double> cdf(KEY_SPACE);
+    double sum = 0;
+    for (int i = 0; i < KEY_SPACE; ++i)
+    {
+        sum += 1.0 / std::pow(i + 1, 0.9);
+        cdf[i] = sum;
+    }
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> uniform(0, sum);
+    std::vector<int> trace(OPERATIONS);
+    int scanKey = KEY_SPACE;
+    for (int op = 0; op < OPERATIONS; ++op)
+    {
+        if ((op / SEGMENT) % 4 == 3) trace[op] = scanKey++;
+        else trace[op] = static_cast<int>(std::lower_bound(cdf.begin(), cdf.end(), uniform(gen)) - cdf.begin());
+    }
+
+    myCache::LRUCache<int, std::string> lru(CAPACITY);
+    myCache::LFUCache<int, std::string> lfu(CAPACITY);
+    myCache::ArcCache<int, std::string> arc(CAPACITY / 2);
+    myCache::TinyLFUCache<int, std::string> tinyLfu(CAPACITY);
+    myCache::S3FIFOCache<int, std::string> s3fifo(CAPACITY);
+
+    std::array<myCache::CachePolicy<int, std::string> *, 5> caches = {&lru, &lfu, &arc, &tinyLfu, &s3fifo};
+    std::vector<int> hits(5, 0);
+    std::vector<int> get_operations(5, 0);
+    for (size_t i = 0; i < caches.size(); ++i)
+    {
+        for (int key : trace)
+        {
+            get_operations[i]++;
+            std::string result;
+            if (caches[i]->get(key, result)) hits[i]++;
+            else caches[i]->put(key, "zipf" + std::to_string(key));
+        }
+    }
+    printResults("扫描 + Zipf 混合测试", CAPACITY, get_operations, hits);
+}
+
 int main()
 {
     testHotDataAccess();
     testLoopPattern();
     testWorkloadShift();
+    testLruThroughput();
+    testArcLfuHitLatency();
+    testReadHeavyScaling();
+    testConcurrentScaling();
+    testShardFalseSharing();
+    testShardRebalance();
+    testBatchGet();
+    testLoadStampede();
+    testScanZipf();
     return 0;
 }
\ No newline at end of file